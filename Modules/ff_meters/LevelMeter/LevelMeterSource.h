@@ -61,22 +61,20 @@ private:
         maxOverall (),
         clip (false),
         reduction (1.0f),
-        hold (0),
-        rmsHistory ((size_t) rmsWindow, 0.0),
-        rmsSum (0.0),
-        rmsPtr (0)
-        {}
+        hold (0)
+        {
+            setRMSsize (rmsWindow);
+        }
 
         ChannelData (const ChannelData& other) :
         max       (other.max.load() ),
         maxOverall(other.maxOverall.load() ),
         clip      (other.clip.load() ),
         reduction (other.reduction.load()),
-        hold      (other.hold.load()),
-        rmsHistory (8, 0.0),
-        rmsSum    (0.0),
-        rmsPtr    (0)
-        {}
+        hold      (other.hold.load())
+        {
+            setRMSsize (8);
+        }
 
         ChannelData& operator=(const ChannelData& other)
         {
@@ -85,9 +83,7 @@ private:
             clip.store        (other.clip.load());
             reduction.store   (other.reduction.load());
             hold.store        (other.hold.load());
-            rmsHistory.resize (other.rmsHistory.size(), 0.0);
-            rmsSum = 0.0;
-            rmsPtr = 0;
+            setRMSsize        (other.rmsWindow.getSize());
             return (*this);
         }
 
@@ -96,14 +92,13 @@ private:
         std::atomic<bool>        clip;
         std::atomic<float>       reduction;
 
+        /**
+         Constant time and safe to call from the GUI thread, it only reads the
+         mean square the audio thread published with the last block.
+         */
         float getAvgRMS () const
         {
-            if (rmsHistory.size() > 0)
-                return std::sqrt(static_cast<float>(
-                    std::accumulate (rmsHistory.begin(), rmsHistory.end(), 0.0) /
-                    static_cast<float>(rmsHistory.size())));
-                
-            return float (std::sqrt (rmsSum));
+            return float (std::sqrt (rmsWindow.get()));
         }
 
         void setLevels (const juce::int64 time, const float newMax, const float newRms, const juce::int64 newHoldMSecs)
@@ -124,34 +119,24 @@ private:
             pushNextRMS (std::min (1.0f, newRms));
         }
 
+        /**
+         Sets the capacity of the rms ring. This allocates, so call it from resize
+         and not while the audio thread is measuring.
+         */
         void setRMSsize (const size_t numBlocks)
         {
-            rmsHistory.assign (numBlocks, 0.0);
-            rmsSum  = 0.0;
-            if (numBlocks > 1)
-                rmsPtr %= rmsHistory.size();
-            else
-                rmsPtr = 0;
+            rmsWindow.setSize (numBlocks);
         }
     private:
         void pushNextRMS (const float newRMS)
         {
-            const double squaredRMS = std::min (newRMS * newRMS, 1.0f);
-            if (rmsHistory.size() > 0)
-            {
-                rmsHistory [(size_t) rmsPtr] = squaredRMS;
-                rmsPtr = (rmsPtr + 1) % rmsHistory.size();
-            }
-            else
-            {
-                rmsSum = squaredRMS;
-            }
+            rmsWindow.push (std::min (newRMS * newRMS, 1.0f));
         }
 
         std::atomic<juce::int64> hold;
-        std::vector<double>      rmsHistory;
-        std::atomic<double>      rmsSum;
-        size_t                   rmsPtr;
+
+        // pushed by the audio thread, the GUI only reads the published mean
+        RunningMeanSquare        rmsWindow;
     };
 
 public:
@@ -181,6 +166,9 @@ public:
         for (ChannelData& l : levels)
             l.setRMSsize (size_t (rmsWindow));
 
+        peaks.resize (size_t (channels));
+        sumsOfSquares.resize (size_t (channels));
+
         newDataFlag = true;
     }
 
@@ -193,14 +181,23 @@ public:
         lastMeasurement = juce::Time::currentTimeMillis();
         if (! suspended)
         {
-            const int         numChannels = buffer.getNumChannels ();
+            const int         numChannels = std::min (buffer.getNumChannels (), int (levels.size()));
             const int         numSamples  = buffer.getNumSamples ();
 
-            for (int channel=0; channel < std::min (numChannels, int (levels.size())); ++channel) {
-                levels [size_t (channel)].setLevels (lastMeasurement,
-                                                     buffer.getMagnitude (channel, 0, numSamples),
-                                                     buffer.getRMSLevel  (channel, 0, numSamples),
-                                                     holdMSecs);
+            // one pass over all channels instead of getMagnitude and getRMSLevel reading each twice
+            if (buffer.hasBeenCleared() || numSamples <= 0)
+            {
+                std::fill (peaks.begin(), peaks.begin() + numChannels, 0.0f);
+                std::fill (sumsOfSquares.begin(), sumsOfSquares.begin() + numChannels, 0.0);
+            }
+            else
+            {
+                measureChannels (buffer.getArrayOfReadPointers(), numChannels, numSamples);
+            }
+
+            for (int channel=0; channel < numChannels; ++channel) {
+                const auto rms = numSamples > 0 ? float (std::sqrt (sumsOfSquares [size_t (channel)] / numSamples)) : 0.0f;
+                levels [size_t (channel)].setLevels (lastMeasurement, peaks [size_t (channel)], rms, holdMSecs);
             }
         }
 
@@ -367,6 +364,20 @@ public:
     }
 
 private:
+    void measureChannels (const float* const* channels, const int numChannels, const int numSamples)
+    {
+        MeterKernels::findPeakAndSumOfSquares (channels, numChannels, numSamples, peaks.data(), sumsOfSquares.data());
+    }
+
+    void measureChannels (const double* const* channels, const int numChannels, const int numSamples)
+    {
+        for (int channel=0; channel < numChannels; ++channel) {
+            double peak;
+            MeterKernels::findPeakAndSumOfSquares (channels [channel], numSamples, peak, sumsOfSquares [size_t (channel)]);
+            peaks [size_t (channel)] = float (peak);
+        }
+    }
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (LevelMeterSource)
     juce::WeakReference<LevelMeterSource>::Master masterReference;
     friend class juce::WeakReference<LevelMeterSource>;
@@ -375,6 +386,10 @@ private:
 
     std::vector<ChannelData> levels;
 
+    // per channel results of measureBlock, sized in resize so the audio thread doesn't allocate
+    std::vector<float>       peaks;
+    std::vector<double>      sumsOfSquares;
+
     juce::int64 holdMSecs;
 
     std::atomic<juce::int64> lastMeasurement;
@@ -48,19 +48,58 @@ namespace foleys
      This class implements a circular buffer to store min and max values
      of anaudio signal. The block size can be specified. At any time the
      UI can request an outline of the last n blocks as Path to fill or stroke
+
+     Each channel keeps a min/max pyramid on top of the blocks: level k holds
+     one entry per 2^k blocks and is updated as each block completes, at a
+     cost of one min and one max per level. An outline reads the finest level
+     that fits the width of its bounds, so zooming out to a long history costs
+     about as many points as there are pixels.
      */
     class OutlineBuffer
     {
 
         class ChannelData
         {
-            std::vector<float>           minBuffer;
-            std::vector<float>           maxBuffer;
-            std::atomic<size_t>          writePointer     {0};
+            struct Level
+            {
+                std::vector<float> minBuffer;
+                std::vector<float> maxBuffer;
+            };
+
+            std::vector<Level>           levels;
+            std::atomic<juce::int64>     numBlocksWritten { 0 };
             int                          fraction        = 0;
             int                          samplesPerBlock = 128;
 
             JUCE_LEAK_DETECTOR (ChannelData)
+
+            /** Folds the block that just completed into every coarser level, then publishes it */
+            void finishBlock (const juce::int64 block)
+            {
+                const auto& finest = levels.front();
+                const auto  index  = size_t (block % juce::int64 (finest.minBuffer.size()));
+                const auto  lower  = finest.minBuffer [index];
+                const auto  upper  = finest.maxBuffer [index];
+
+                for (size_t k=1; k < levels.size(); ++k)
+                {
+                    auto& level = levels [k];
+                    const auto entry = size_t ((block >> k) % juce::int64 (level.minBuffer.size()));
+                    if ((block & ((juce::int64 (1) << k) - 1)) == 0)
+                    {
+                        level.minBuffer [entry] = lower;
+                        level.maxBuffer [entry] = upper;
+                    }
+                    else
+                    {
+                        level.minBuffer [entry] = std::min (level.minBuffer [entry], lower);
+                        level.maxBuffer [entry] = std::max (level.maxBuffer [entry], upper);
+                    }
+                }
+
+                numBlocksWritten.store (block + 1, std::memory_order_release);
+            }
+
         public:
             ChannelData ()
             {
@@ -80,7 +119,7 @@ namespace foleys
              */
             int getSize () const
             {
-                return static_cast<int> (minBuffer.size());
+                return levels.empty() ? 0 : static_cast<int> (levels.front().minBuffer.size());
             }
 
             void setSamplesPerBlock (const int numSamples)
@@ -90,83 +129,106 @@ namespace foleys
 
             /**
              @param numBlocks is the number of values the buffer will store. Allow a little safety buffer, so you
-             don't write into the part, where it is currently read
+             don't write into the part, where it is currently read. This clears the history.
              */
             void setSize (const int numBlocks)
             {
-                minBuffer.resize (size_t (numBlocks), 0.0f);
-                maxBuffer.resize (size_t (numBlocks), 0.0f);
-                writePointer = writePointer % size_t (numBlocks);
+                jassert (numBlocks > 0);
+
+                // two spare entries per coarser level for the partly filled ones at either end of a window
+                levels.resize (1);
+                for (int k=1; (numBlocks >> k) > 0; ++k)
+                    levels.emplace_back();
+
+                for (size_t k=0; k < levels.size(); ++k)
+                {
+                    const auto size = k == 0 ? size_t (numBlocks) : size_t ((numBlocks >> k) + 2);
+                    levels [k].minBuffer.assign (size, 0.0f);
+                    levels [k].maxBuffer.assign (size, 0.0f);
+                }
+
+                numBlocksWritten = 0;
+                fraction = 0;
             }
 
             void pushChannelData (const float* input, const int numSamples)
             {
-                // create peak values
+                auto& finest = levels.front();
+                auto  block  = numBlocksWritten.load (std::memory_order_relaxed);
+
+                // create peak values, a block can span several pushes
                 int samples = 0;
-                juce::Range<float> minMax;
                 while (samples < numSamples)
                 {
-                    auto leftover = numSamples - samples;
-                    if (fraction > 0)
+                    // at least one sample, in case the block size shrank below the fraction
+                    const auto num    = std::min (numSamples - samples, std::max (1, samplesPerBlock - fraction));
+                    const auto minMax = juce::FloatVectorOperations::findMinAndMax (input + samples, num);
+                    jassert (minMax.getStart() == minMax.getStart() && minMax.getEnd() == minMax.getEnd());
+
+                    const auto index = size_t (block % juce::int64 (finest.minBuffer.size()));
+                    if (fraction == 0)
                     {
-                        minMax = juce::FloatVectorOperations::findMinAndMax (input, samplesPerBlock - fraction);
-                        maxBuffer [(size_t) writePointer] = std::max (maxBuffer [(size_t) writePointer], minMax.getEnd());
-                        minBuffer [(size_t) writePointer] = std::min (minBuffer [(size_t) writePointer], minMax.getStart());
-                        samples += samplesPerBlock - fraction;
-                        fraction = 0;
-                        writePointer = (writePointer + 1) % maxBuffer.size();
+                        finest.minBuffer [index] = minMax.getStart();
+                        finest.maxBuffer [index] = minMax.getEnd();
                     }
-                    else if (leftover > samplesPerBlock)
+                    else
                     {
-                        minMax = juce::FloatVectorOperations::findMinAndMax (input + samples, samplesPerBlock);
-                        maxBuffer [(size_t) writePointer] = minMax.getEnd();
-                        minBuffer [(size_t) writePointer] = minMax.getStart();
-                        samples += samplesPerBlock;
-                        writePointer = (writePointer + 1) % maxBuffer.size();
+                        finest.minBuffer [index] = std::min (finest.minBuffer [index], minMax.getStart());
+                        finest.maxBuffer [index] = std::max (finest.maxBuffer [index], minMax.getEnd());
                     }
-                    else
+
+                    samples  += num;
+                    fraction += num;
+                    if (fraction >= samplesPerBlock)
                     {
-                        minMax = juce::FloatVectorOperations::findMinAndMax (input + samples, leftover);
-                        maxBuffer [(size_t) writePointer] = minMax.getEnd();
-                        minBuffer [(size_t) writePointer] = minMax.getStart();
-                        samples += samplesPerBlock - fraction;
-                        fraction = leftover;
+                        fraction = 0;
+                        finishBlock (block++);
                     }
-                    jassert (minMax.getStart() == minMax.getStart() && minMax.getEnd() == minMax.getEnd());
                 }
             }
 
             void getChannelOutline (juce::Path& outline, const juce::Rectangle<float> bounds, const int numSamplesToPlot) const
             {
-                auto numSamples = size_t (numSamplesToPlot);
-                auto latest = writePointer > 0 ? writePointer - 1 : maxBuffer.size() - 1;
-                auto oldest = (latest >= numSamples) ? latest - numSamples : latest + maxBuffer.size() - numSamples;
+                if (numSamplesToPlot <= 0 || levels.empty())
+                    return;
+
+                const auto numBlocks = juce::int64 (std::min (numSamplesToPlot, getSize()));
+                const auto latest    = numBlocksWritten.load (std::memory_order_acquire) - 1;
+                const auto oldest    = latest - numBlocks + 1;
+
+                // the finest level with no more entries than pixels
+                const auto pixels = juce::int64 (std::max (1, juce::roundToInt (bounds.getWidth())));
+                size_t k = 0;
+                while (k + 1 < levels.size() && ((numBlocks - 1) >> k) + 1 > pixels)
+                    ++k;
+
+                const auto& level = levels [k];
+                const auto  size  = juce::int64 (level.minBuffer.size());
+                const auto  first = oldest >> k;
+                const auto  last  = latest >> k;
+
+                // blocks before the first one pushed read as silence
+                auto entryAt = [&] (const std::vector<float>& values, const juce::int64 entry)
+                {
+                    return entry < 0 ? 0.0f : values [size_t (entry % size)];
+                };
 
-                const auto dx = bounds.getWidth() / numSamples;
+                const auto dx = bounds.getWidth() / float (last - first + 1);
                 const auto dy = bounds.getHeight() * 0.35f;
                 const auto my = bounds.getCentreY();
                 auto  x  = bounds.getX();
-                auto  s  = oldest;
 
                 outline.startNewSubPath (x, my);
-                for (size_t i=0; i < numSamples; ++i)
+                for (auto entry = first; entry <= last; ++entry)
                 {
-                    outline.lineTo (x, my + minBuffer [s] * dy);
+                    outline.lineTo (x, my + entryAt (level.minBuffer, entry) * dy);
                     x += dx;
-                    if (s < minBuffer.size() - 1)
-                        s += 1;
-                    else
-                        s = 0;
                 }
 
-                for (size_t i=0; i < numSamples; ++i)
+                for (auto entry = last; entry >= first; --entry)
                 {
-                    outline.lineTo (x, my + maxBuffer [s] * dy);
                     x -= dx;
-                    if (s > 1)
-                        s -= 1;
-                    else
-                        s = maxBuffer.size() - 1;
+                    outline.lineTo (x, my + entryAt (level.maxBuffer, entry) * dy);
                 }
             }
         };
@@ -48,27 +48,72 @@ namespace foleys
      This class implements a circular buffer to buffer audio samples.
      At any time the GUI can ask for a stereo field visualisation of
      two neightbouring channels.
+
+     The audio thread is the single writer: pushing never allocates, and the new
+     write position is published with release semantics once the samples are in.
+     For each pair of neighbouring channels (0,1), (2,3)... the direction of the
+     loudest sample in every block of samplesPerDirection samples is kept in a
+     small ring alongside, so getDirections reads a few hundred entries instead of
+     running atan2 over every sample it draws.
      */
     template<typename FloatType>
     class StereoFieldBuffer
     {
-        juce::AudioBuffer<FloatType> sampleBuffer;
-        std::atomic<int>             writePosition = { 0 };
-        std::vector<FloatType>       maxValues     = { 180, 0.0 };
+    public:
+        /** Number of directions getDirections reports, one per degree */
+        static constexpr int numDirections      = 180;
+
+        /** Decimation of the direction history, only the loudest sample of each block is kept */
+        static constexpr int samplesPerDirection = 16;
+
+    private:
+        struct DirectionTrack
+        {
+            std::vector<juce::uint8> index;
+            std::vector<FloatType>   magnitude;
+            std::atomic<int>         writePosition = { 0 };
+
+            // the block still being filled, only touched by the writer
+            FloatType bestSquare = 0;
+            FloatType bestLeft   = 0;
+            FloatType bestRight  = 0;
+            int       fill       = 0;
+        };
+
+        juce::AudioBuffer<FloatType>      sampleBuffer;
+        std::atomic<int>                  writePosition = { 0 };
+        std::vector<FloatType>            maxValues     = { 180, 0.0 };
+
+        std::unique_ptr<DirectionTrack[]> directionTracks;
+        int                               numDirectionTracks = 0;
+        int                               directionCapacity  = 0;
 
         JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (StereoFieldBuffer)
 
-        inline void computeDirection (std::vector<float>& directions, const FloatType left, const FloatType right) const
+        /** Maps a sample pair to a degree, 45 is hard right, 90 is mono and 135 hard left.
+            Opposite points share a direction, so the polarity of a sample does not matter. */
+        static inline int directionIndex (const FloatType left, const FloatType right)
         {
-            if (left == 0)
+            auto side = right - left;
+            auto mid  = left + right;
+            if (mid < 0 || (mid == 0 && side < 0))
             {
-                directions [45] = std::max (directions [45], std::abs (right));
+                side = -side;
+                mid  = -mid;
             }
-            else if (left * right > 0)
-            {
 
-            }
+            const auto degrees = std::atan2 (mid, side) * FloatType (180) / juce::MathConstants<FloatType>::pi;
+            return juce::jlimit (0, numDirections - 1, int (degrees));
+        }
 
+        inline void computeDirection (std::vector<FloatType>& directions, const FloatType left, const FloatType right) const
+        {
+            const auto magnitude = std::sqrt (left * left + right * right);
+            if (magnitude > 0)
+            {
+                auto& direction = directions [size_t (directionIndex (left, right))];
+                direction = std::max (direction, magnitude);
+            }
         }
 
         inline juce::Point<FloatType> computePosition (const juce::Rectangle<FloatType>& b, const FloatType left, const FloatType right) const
@@ -77,38 +122,113 @@ namespace foleys
                                            b.getCentreY() + FloatType (0.5) * b.getHeight() * (left + right));
         }
 
+        template<typename ChannelAccess>
+        void pushChannels (ChannelAccess&& channel, int numChannels, int numSamples)
+        {
+            jassert (numChannels == sampleBuffer.getNumChannels());
+
+            const auto size = sampleBuffer.getNumSamples();
+            if (size == 0 || numSamples <= 0)
+                return;
+
+            // a block longer than the buffer only leaves its tail behind
+            const auto skip = std::max (0, numSamples - size);
+            const auto num  = numSamples - skip;
+            const auto numChannelsToCopy = std::min (numChannels, sampleBuffer.getNumChannels());
+
+            auto pos   = writePosition.load (std::memory_order_relaxed);
+            auto space = size - pos;
+            if (space >= num) {
+                for (int c=0; c < numChannelsToCopy; ++c) {
+                    sampleBuffer.copyFrom (c, pos, channel (c) + skip, num);
+                }
+                pos += num;
+            }
+            else {
+                for (int c=0; c < numChannelsToCopy; ++c) {
+                    sampleBuffer.copyFrom (c, pos, channel (c) + skip,         space);
+                    sampleBuffer.copyFrom (c, 0,   channel (c) + skip + space, num - space);
+                }
+                pos = num - space;
+            }
+            writePosition.store (pos == size ? 0 : pos, std::memory_order_release);
+
+            for (int t=0; t < numDirectionTracks && 2 * t + 1 < numChannels; ++t)
+                pushDirections (directionTracks [t], channel (2 * t) + skip, channel (2 * t + 1) + skip, num);
+        }
+
+        void pushDirections (DirectionTrack& track, const FloatType* left, const FloatType* right, int numSamples)
+        {
+            auto pos = track.writePosition.load (std::memory_order_relaxed);
+
+            for (int i=0; i < numSamples; ++i)
+            {
+                const auto square = left [i] * left [i] + right [i] * right [i];
+                if (square > track.bestSquare)
+                {
+                    track.bestSquare = square;
+                    track.bestLeft   = left [i];
+                    track.bestRight  = right [i];
+                }
+
+                if (++track.fill == samplesPerDirection)
+                {
+                    track.index     [size_t (pos)] = juce::uint8 (track.bestSquare > 0 ? directionIndex (track.bestLeft, track.bestRight) : 0);
+                    track.magnitude [size_t (pos)] = std::sqrt (track.bestSquare);
+                    pos = (pos + 1 == directionCapacity) ? 0 : pos + 1;
+
+                    track.bestSquare = 0;
+                    track.fill       = 0;
+                }
+            }
+
+            track.writePosition.store (pos, std::memory_order_release);
+        }
+
     public:
         StereoFieldBuffer ()
         {
         }
 
+        /** Allocates the buffers, call this before audio is pushed, e.g. in prepareToPlay */
         void setBufferSize (int newNumChannels, int newNumSamples)
         {
             sampleBuffer.setSize (newNumChannels, newNumSamples);
             sampleBuffer.clear();
             writePosition = 0;
+
+            // one spare block, so the reader never walks into the block being written
+            numDirectionTracks = newNumChannels / 2;
+            directionCapacity  = newNumSamples / samplesPerDirection + 2;
+            directionTracks.reset (numDirectionTracks > 0 ? new DirectionTrack [size_t (numDirectionTracks)] : nullptr);
+            for (int t=0; t < numDirectionTracks; ++t)
+            {
+                directionTracks [t].index.assign     (size_t (directionCapacity), 0);
+                directionTracks [t].magnitude.assign (size_t (directionCapacity), FloatType (0));
+            }
         }
 
-        void pushSampleBlock (juce::AudioBuffer<FloatType> buffer, int numSamples)
+        /** Copies numSamples of each channel into the buffer, without copying the buffer itself */
+        void pushSampleBlock (const juce::AudioBuffer<FloatType>& buffer, int numSamples)
         {
-            jassert (buffer.getNumChannels() == sampleBuffer.getNumChannels());
+            jassert (numSamples <= buffer.getNumSamples());
+            pushChannels ([&buffer] (int c) { return buffer.getReadPointer (c); }, buffer.getNumChannels(), numSamples);
+        }
 
-            auto pos   = writePosition.load();
-            auto space = sampleBuffer.getNumSamples() - pos;
-            if (space >= numSamples) {
-                for (int c=0; c < sampleBuffer.getNumChannels(); ++c) {
-                    sampleBuffer.copyFrom (c, pos, buffer.getReadPointer(c), numSamples);
-                }
-                writePosition = pos + numSamples;
-            }
-            else {
-                for (int c=0; c < sampleBuffer.getNumChannels(); ++c) {
-                    sampleBuffer.copyFrom (c, pos, buffer.getReadPointer(c),        space);
-                    sampleBuffer.copyFrom (c, 0,   buffer.getReadPointer(c, space), numSamples - space);
-                }
-                writePosition = numSamples - space;
-            }
+        /** Pushes numSamples from an array of channel pointers, e.g. straight from an audio callback */
+        void pushSampleBlock (const FloatType* const* channels, int numChannels, int numSamples)
+        {
+            pushChannels ([channels] (int c) { return channels [c]; }, numChannels, numSamples);
+        }
+
+#if JUCE_MODULE_AVAILABLE_juce_dsp
+        /** Pushes a non-owning view, e.g. the block of a juce::dsp::ProcessContext */
+        void pushSampleBlock (const juce::dsp::AudioBlock<const FloatType>& block)
+        {
+            pushChannels ([&block] (int c) { return block.getChannelPointer (size_t (c)); },
+                          int (block.getNumChannels()), int (block.getNumSamples()));
         }
+#endif
 
         void resetMaxValues ()
         {
@@ -120,7 +240,7 @@ namespace foleys
         juce::Path getOscilloscope (const int numSamples, const juce::Rectangle<FloatType> bounds, int leftIdx, int rightIdx) const
         {
             juce::Path curve;
-            auto pos = writePosition.load();
+            auto pos = writePosition.load (std::memory_order_acquire);
             if (pos >= numSamples)
             {
                 auto* left  = sampleBuffer.getReadPointer (leftIdx,  pos - numSamples);
@@ -157,11 +277,30 @@ namespace foleys
 
         //  ==============================================================================
 
+        /** Fills directions with the loudest magnitude seen in each degree over the last numSamples.
+            For neighbouring pairs (0,1), (2,3)... this reads the decimated history, any other pair
+            of channels is scanned sample by sample. */
         void getDirections (std::vector<FloatType>& directions, int numSamples, int leftIdx, int rightIdx)
         {
-            jassert (directions.size() == 180);
+            jassert (directions.size() == numDirections);
             std::fill (directions.begin(), directions.end(), 0.0);
-            auto pos = writePosition.load();
+
+            if (leftIdx % 2 == 0 && rightIdx == leftIdx + 1 && leftIdx / 2 < numDirectionTracks)
+            {
+                const auto& track = directionTracks [leftIdx / 2];
+                const auto  pos   = track.writePosition.load (std::memory_order_acquire);
+                const auto  num   = std::min ((numSamples + samplesPerDirection - 1) / samplesPerDirection, directionCapacity - 1);
+
+                for (int i=0, entry = pos - num + (pos < num ? directionCapacity : 0); i < num; ++i)
+                {
+                    auto& direction = directions [track.index [size_t (entry)]];
+                    direction = std::max (direction, track.magnitude [size_t (entry)]);
+                    entry = (entry + 1 == directionCapacity) ? 0 : entry + 1;
+                }
+                return;
+            }
+
+            auto pos = writePosition.load (std::memory_order_acquire);
 
             if (pos >= numSamples)
             {
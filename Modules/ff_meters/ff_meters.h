@@ -61,10 +61,17 @@
 #include <juce_gui_basics/juce_gui_basics.h>
 #include <juce_events/juce_events.h>
 
+#if JUCE_MODULE_AVAILABLE_juce_dsp
+ #include <juce_dsp/juce_dsp.h>
+#endif
+
 #include <atomic>
 #include <vector>
 #include <numeric>
 
+// the measurement core, shared with the headless meter in libgenisys-dsp
+#include <genisys/genisys_levelmeter.h>
+
 #include "LevelMeter/LevelMeterSource.h"
 #include "LevelMeter/LevelMeter.h"
 #include "Visualisers/OutlineBuffer.h"
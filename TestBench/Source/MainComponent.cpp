@@ -19,11 +19,13 @@ MainComponent::MainComponent() : keyboardComponent (keyboardState, juce::MidiKey
     midGray = juce::Colour(0xFF425568);
     midBlack = juce::Colour(0xFF100B28);
 
-    backgroundThread.startThread();
     formatManager.registerBasicFormats();
 
     libGenisysInstance = LibGenisysCreate();
 
+    //The sample files get replayed over and over, only the first play of each needs inference
+    LibGenisysSetTranscriptCache(libGenisysInstance, 64, 1 << 20);
+
     //Initial size big enough for most Desktop and Laptop displays
     //TODO: Make resizable layout
     setSize (800, 800);
@@ -226,14 +228,20 @@ void MainComponent::loadCloseTestFile()
 void MainComponent::processAudioFile(juce::File file, bool deleteAfterRender)
 {
     auto result = LibGenisysProcessNativePath(libGenisysInstance, file.getFullPathName().toStdString());
-    if (!result.empty())
-        textDisplay.setText(juce::String(result), juce::dontSendNotification);
 
     //Keep user's disk tidy unless we are purposely recording files to train the model
     //TODO: Develop system for batch recording and submitting audio files
     if (deleteAfterRender)
         file.deleteFile();
 
+    processTranscript(result);
+}
+
+void MainComponent::processTranscript(const std::string& result)
+{
+    if (!result.empty())
+        textDisplay.setText(juce::String(result), juce::dontSendNotification);
+
 #ifdef __APPLE__
     if (result.find("genesis") != std::string::npos)
     {
@@ -302,30 +310,15 @@ void MainComponent::prepareToPlay(int samplesPerBlockExpected, double sampleRate
                         "Up-sampling might produce erratic speech recognition.\n", targetSampleRate, (int)sampleRate);
     }
 
-    const int resamplerBlockSize = samplesPerBlockExpected;
-    const int resamplerMaxSamples = maxInputSampleRate * 2;
-
     if (currentBlockSize != samplesPerBlockExpected || currentSampleRate != sampleRate) {
         meterSource.resize(1, static_cast<int>(sampleRate * 0.1 / samplesPerBlockExpected));
-        LibGenisysInitialize(libGenisysInstance, samplesPerBlockExpected, sampleRate);
-    }
-
-    if (currentBlockSize != samplesPerBlockExpected)
-    {
-        currentBlockSize = samplesPerBlockExpected;
-        resamplerBuffer = std::make_unique<juce::AudioBuffer<float>>(1, currentBlockSize);
-
-        if (!inputResampler)
-            inputResampler = std::make_unique<gin::ResamplingFifo>(resamplerBlockSize, 1, resamplerMaxSamples);
-        else
-            inputResampler->setSize(resamplerBlockSize, 1, resamplerMaxSamples);
-    }
 
-    if (currentSampleRate != sampleRate)
-    {
-        currentSampleRate = sampleRate;
-        inputResampler->setResamplingRatio(currentSampleRate, targetSampleRate);
-        inputResampler->reset();
+        //Refused while a recording is being transcribed, so it is retried on the next prepareToPlay
+        if (LibGenisysInitialize(libGenisysInstance, samplesPerBlockExpected, sampleRate) == LibGenisysStatusOk)
+        {
+            currentBlockSize = samplesPerBlockExpected;
+            currentSampleRate = sampleRate;
+        }
     }
 
     openTransportSource->prepareToPlay (samplesPerBlockExpected, sampleRate);
@@ -340,19 +333,11 @@ void MainComponent::prepareToPlay(int samplesPerBlockExpected, double sampleRate
 
         if (currentlyRecordingCommandSample)
         {
-            inputResampler.get()->pushAudioBuffer(*bufferToFill.buffer);
-
-            while (inputResampler.get()->samplesReady() >= currentBlockSize)
-            {
-                inputResampler.get()->popAudioBuffer(*resamplerBuffer);
-
-                const juce::ScopedLock sl (writerLock);
-
-                if (activeWriter.load() != nullptr)
-                {
-                    activeWriter.load()->write(resamplerBuffer->getArrayOfReadPointers(), currentBlockSize);
-                }
-            }
+            //Only copies into the library's ring, no locks or allocation on the audio thread
+            if (LibGenisysPushFloat(libGenisysInstance,
+                                    bufferToFill.buffer->getReadPointer(0, bufferToFill.startSample),
+                                    bufferToFill.numSamples) == LibGenisysOverrun)
+                ++droppedBlocks;
 
             if (!enablePassthrough)
                 bufferToFill.clearActiveBufferRegion();
@@ -478,40 +463,26 @@ void MainComponent::startRecording()
 {
     stop();
 
-    lastRecording = juce::File::getSpecialLocation(juce::File::SpecialLocationType::tempDirectory)
-                               .getChildFile("temp.wav");
+    droppedBlocks = 0;
 
     if (currentSampleRate > 0)
-    {
-        if (auto fileStream = std::unique_ptr<juce::FileOutputStream> (lastRecording.createOutputStream()))
-        {
-            juce::WavAudioFormat wavFormat;
-
-            if (auto writer = wavFormat.createWriterFor (fileStream.get(), targetSampleRate, 1, 16, {}, 0))
-            {
-                fileStream.release();
-
-                threadedWriter.reset (new juce::AudioFormatWriter::ThreadedWriter (writer, backgroundThread, 32768));
-
-                const juce::ScopedLock sl (writerLock);
-                activeWriter = threadedWriter.get();
-            }
-        }
-    }
+        LibGenisysStartListening(libGenisysInstance);
 }
 
 void MainComponent::stop()
 {
-    const juce::ScopedLock sl (writerLock);
-    activeWriter = nullptr;
-    threadedWriter.reset();
+    LibGenisysStopListening(libGenisysInstance);
 }
 
 void MainComponent::stopRecordingAndConvert()
 {
-    stop();
     currentlyRecordingCommandSample = false;
-    processAudioFile(lastRecording, true);
+    const auto result = LibGenisysStopListening(libGenisysInstance);
+
+    if (droppedBlocks > 0)
+        logMessage("Dropped audio in " + juce::String(droppedBlocks.load()) + " blocks while recording");
+
+    processTranscript(result);
 }
 
 juce::String MainComponent::getMidiMessageDescription (const juce::MidiMessage& m)
@@ -88,16 +88,16 @@ private:
     foleys::LevelMeterSource meterSource;
 
     //DSP
-    std::unique_ptr<juce::AudioBuffer<float>> resamplerBuffer;
-    std::unique_ptr<gin::ResamplingFifo> inputResampler;
     const int targetSampleRate = 16000;
-    const int maxInputSampleRate = 96000;
 
     int currentBlockSize = 0;
     int currentSampleRate = 0;
 
+    //Recordings are pushed to the library from the audio callback, it resamples and transcribes them on its own thread
     LibGenisysInstance libGenisysInstance;
+    std::atomic<int> droppedBlocks { 0 };
     void processAudioFile(juce::File file, bool deleteAfterRender);
+    void processTranscript(const std::string& result);
 
     bool currentlyRecordingCommandSample = false;
     bool shouldPlayOpenCommandSample = true;
@@ -110,14 +110,9 @@ private:
     std::unique_ptr<juce::AudioTransportSource> closeTransportSource;
 
     juce::AudioFormatManager formatManager;
-    juce::File lastRecording;
     juce::AudioBuffer<float> openAudioBuffer;
     juce::AudioBuffer<float> closeAudioBuffer;
 
-    juce::TimeSliceThread backgroundThread { "Audio Recorder Thread" };
-    std::unique_ptr<juce::AudioFormatWriter::ThreadedWriter> threadedWriter;
-    juce::CriticalSection writerLock;
-    std::atomic<juce::AudioFormatWriter::ThreadedWriter*> activeWriter { nullptr };
 
     juce::File openTestFile;
     juce::String openTestFilePath;
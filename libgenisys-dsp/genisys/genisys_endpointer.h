@@ -0,0 +1,203 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+//==============================================================================
+/** Endpointer - finds the spans of speech in a 16 bit signal.
+
+    The signal is classified in 10ms frames. A frame counts as speech when its
+    energy is a margin above a running noise floor, or when an external voice
+    probability for it (e.g. the one rnnoise_process_frame returns) is above a
+    threshold. Speech is padded on both sides, and a pause longer than
+    splitPauseMs ends the current segment so long recordings are cut at pauses.
+*/
+class Endpointer
+{
+public:
+    struct Segment
+    {
+        int start = 0; /**< First sample of the segment */
+        int end = 0;   /**< One past the last sample of the segment */
+    };
+
+    struct Settings
+    {
+        int sampleRate = 16000;
+        int frameMs = 10;
+        float energyMarginDb = 10.0f;             /**< Frames this far above the noise floor are speech */
+        float minSpeechDb = -50.0f;               /**< Frames quieter than this are never speech */
+        float voiceProbabilityThreshold = 0.5f;   /**< Used instead of energy when probabilities are given */
+        int paddingMs = 200;                      /**< Kept before and after each segment */
+        int splitPauseMs = 700;                   /**< Silence longer than this ends a segment */
+        int minSpeechMs = 60;                     /**< Shorter bursts are dropped as clicks */
+    };
+
+    Endpointer() { setSettings(Settings()); }
+
+    void setSettings(const Settings& newSettings)
+    {
+        settings = newSettings;
+        frameSize = std::max(1, settings.sampleRate * settings.frameMs / 1000);
+        reset();
+    }
+
+    const Settings& getSettings() const noexcept { return settings; }
+    int getFrameSize() const noexcept { return frameSize; }
+
+    void reset() noexcept
+    {
+        noiseFloorDb = 0.0f;
+        haveNoiseFloor = false;
+    }
+
+    /** Classifies one frame of getFrameSize() samples and updates the noise floor.
+        @param voiceProbability the frame's voice probability in [0, 1], or a negative
+               value to classify on energy alone
+    */
+    bool isSpeechFrame(const short* frame, int numSamples, float voiceProbability = -1.0f) noexcept
+    {
+        return classify(getEnergyDb(frame, numSamples), voiceProbability);
+    }
+
+    /** Seeds the noise floor from the quieter frames of a look-ahead, the way findSegments()
+        does for the whole signal, so frame by frame classification matches it on leading speech.
+    */
+    void seedNoiseFloor(const short* samples, int numSamples)
+    {
+        const int numFrames = numSamples / frameSize;
+        if (numFrames <= 0)
+            return;
+
+        computeFrameEnergies(samples, numFrames);
+        seedNoiseFloorFromEnergies();
+    }
+
+    /** Finds the speech segments in a whole signal.
+        @param voiceProbabilities optional per-frame probabilities, one per getFrameSize() samples
+        @param numProbabilities number of entries in voiceProbabilities; frames past it use energy only
+        @param segments cleared and filled with the segments found, in order
+    */
+    void findSegments(const short* samples,
+                      int numSamples,
+                      const float* voiceProbabilities,
+                      int numProbabilities,
+                      std::vector<Segment>& segments)
+    {
+        segments.clear();
+
+        const int numFrames = numSamples / frameSize;
+        if (numFrames <= 0)
+            return;
+
+        computeFrameEnergies(samples, numFrames);
+        seedNoiseFloorFromEnergies();
+
+        const int splitPauseFrames = std::max(1, settings.splitPauseMs / settings.frameMs);
+        const int minSpeechFrames = std::max(1, settings.minSpeechMs / settings.frameMs);
+        const int padding = settings.paddingMs * settings.sampleRate / 1000;
+
+        int segmentStart = -1, lastSpeech = -1, numSpeechFrames = 0;
+
+        auto closeSegment = [&]()
+        {
+            if (segmentStart >= 0 && numSpeechFrames >= minSpeechFrames)
+            {
+                Segment s;
+                s.start = std::max(0, segmentStart * frameSize - padding);
+                s.end = std::min(numSamples, (lastSpeech + 1) * frameSize + padding);
+
+                // Padding can make neighbours overlap
+                if (!segments.empty() && s.start <= segments.back().end)
+                    segments.back().end = s.end;
+                else
+                    segments.push_back(s);
+            }
+
+            segmentStart = -1;
+            numSpeechFrames = 0;
+        };
+
+        for (int frame = 0; frame < numFrames; ++frame)
+        {
+            const float probability = frame < numProbabilities && voiceProbabilities ? voiceProbabilities[frame] : -1.0f;
+
+            if (classify(frameEnergies[size_t(frame)], probability))
+            {
+                if (segmentStart < 0)
+                    segmentStart = frame;
+
+                lastSpeech = frame;
+                ++numSpeechFrames;
+            }
+            else if (segmentStart >= 0 && frame - lastSpeech > splitPauseFrames)
+            {
+                closeSegment();
+            }
+        }
+
+        closeSegment();
+    }
+
+    static float getEnergyDb(const short* frame, int numSamples) noexcept
+    {
+        if (numSamples <= 0)
+            return -100.0f;
+
+        double sumOfSquares = 0.0;
+        for (int i = 0; i < numSamples; ++i)
+            sumOfSquares += double(frame[i]) * double(frame[i]);
+
+        const double meanSquare = sumOfSquares / (double(numSamples) * 32768.0 * 32768.0);
+        return float(10.0 * std::log10(meanSquare + 1.0e-10));
+    }
+
+private:
+    void computeFrameEnergies(const short* samples, int numFrames)
+    {
+        frameEnergies.resize(size_t(numFrames));
+        for (int frame = 0; frame < numFrames; ++frame)
+            frameEnergies[size_t(frame)] = getEnergyDb(samples + frame * frameSize, frameSize);
+    }
+
+    // Seed the noise floor from the quieter frames so leading speech isn't taken as noise
+    void seedNoiseFloorFromEnergies()
+    {
+        sortedEnergies = frameEnergies;
+        auto quietest = sortedEnergies.begin() + sortedEnergies.size() / 10;
+        std::nth_element(sortedEnergies.begin(), quietest, sortedEnergies.end());
+        noiseFloorDb = *quietest;
+        haveNoiseFloor = true;
+    }
+
+    bool classify(float energyDb, float voiceProbability) noexcept
+    {
+        if (!haveNoiseFloor)
+        {
+            noiseFloorDb = energyDb;
+            haveNoiseFloor = true;
+        }
+
+        const bool loudEnough = energyDb > settings.minSpeechDb;
+        const bool speech = voiceProbability >= 0.0f
+                                ? loudEnough && voiceProbability >= settings.voiceProbabilityThreshold
+                                : loudEnough && energyDb > noiseFloorDb + settings.energyMarginDb;
+
+        // Falls quickly to quiet frames, rises slowly so speech doesn't drag it up
+        if (energyDb < noiseFloorDb)
+            noiseFloorDb += (energyDb - noiseFloorDb) * 0.5f;
+        else if (!speech)
+            noiseFloorDb += (energyDb - noiseFloorDb) * 0.02f;
+
+        return speech;
+    }
+
+    Settings settings;
+    int frameSize = 160;
+
+    float noiseFloorDb = 0.0f;
+    bool haveNoiseFloor = false;
+
+    std::vector<float> frameEnergies, sortedEnergies;
+};
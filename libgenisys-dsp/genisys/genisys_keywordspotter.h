@@ -0,0 +1,434 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+//==============================================================================
+/** KeywordSpotter - finds a spoken keyword in a 16 bit signal by template matching.
+
+    Each 10ms frame is turned into mel cepstral coefficients without c0, so a
+    frame matches on spectral shape rather than on level. Recordings of the
+    keyword are enrolled as templates, and every new frame extends a
+    subsequence DTW against each of them: the keyword may start on any frame
+    and may be spoken up to maxWarp times faster or slower than the template.
+    A match fires once the mean cepstral distance along the best path ending
+    on a template's last frame has dipped below threshold and turned back up.
+
+    The cost is one small FFT per frame plus numCoefficients multiply-adds per
+    template frame, a few microseconds per 10ms, so it can run on every frame
+    of an always-on input where running a full recogniser would not be viable.
+    Like any template matcher it works best with templates recorded by the
+    same speaker on the same microphone.
+*/
+class KeywordSpotter
+{
+public:
+    struct Settings
+    {
+        int sampleRate = 16000;
+        int frameMs = 10;
+        int windowMs = 25;
+        int numBands = 24;
+        int numCoefficients = 12;
+        float lowestHz = 100.0f;
+        float highestHz = 7600.0f;
+        float threshold = 4.0f;        /**< Mean cepstral distance per frame at or below which a match fires */
+        float maxWarp = 2.0f;          /**< Longest stretch or squeeze of a template that still matches */
+        float trimDb = 30.0f;          /**< Template frames this far below the loudest are trimmed from the ends */
+        int maxTemplateMs = 2000;
+        int settleMs = 100;            /**< How long a match must stay the best before it fires */
+        int refractoryMs = 1000;       /**< No new match fires this soon after one */
+    };
+
+    KeywordSpotter() { setSettings(Settings()); }
+
+    /** Clears the templates, which depend on the feature settings */
+    void setSettings(const Settings& newSettings)
+    {
+        settings = newSettings;
+        frameSize = std::max(1, settings.sampleRate * settings.frameMs / 1000);
+        windowSize = std::max(frameSize, settings.sampleRate * settings.windowMs / 1000);
+
+        fftSize = 1;
+        while (fftSize < windowSize)
+            fftSize *= 2;
+
+        prepareFft();
+        prepareFilterbank();
+
+        templates.clear();
+        reset();
+    }
+
+    const Settings& getSettings() const noexcept { return settings; }
+    int getFrameSize() const noexcept { return frameSize; }
+    int getNumTemplates() const noexcept { return (int)templates.size(); }
+
+    /** Clears the streaming state, keeping the templates */
+    void reset() noexcept
+    {
+        resetAnalysis(live);
+        frameIndex = 0;
+        refractoryFrames = 0;
+        lastScore = candidateScore = std::numeric_limits<float>::max();
+        candidateAge = 0;
+
+        for (auto& t : templates)
+            clearPaths(t);
+    }
+
+    /** Enrols a recording of the keyword. Quiet frames at either end are trimmed.
+        @returns false if nothing was left to match against
+    */
+    bool addTemplate(const short* samples, int numSamples)
+    {
+        Template t;
+        std::vector<float> energies;
+
+        //Analysed from a fresh state the same way the live input is, leaving the live state alone
+        Analysis analysis;
+        resetAnalysis(analysis);
+
+        std::vector<float> features(size_t(settings.numCoefficients));
+        for (int offset = 0; offset + frameSize <= numSamples; offset += frameSize)
+        {
+            energies.push_back(computeFeatures(analysis, samples + offset, features.data()));
+            t.features.insert(t.features.end(), features.begin(), features.end());
+        }
+
+        if (energies.empty())
+            return false;
+
+        const float loudest = *std::max_element(energies.begin(), energies.end());
+        int first = 0, last = (int)energies.size() - 1;
+        while (first < last && energies[size_t(first)] < loudest - settings.trimDb)
+            ++first;
+        while (last > first && energies[size_t(last)] < loudest - settings.trimDb)
+            --last;
+
+        last = std::min(last, first + settings.maxTemplateMs / settings.frameMs - 1);
+        t.numFrames = last - first + 1;
+        t.features.erase(t.features.begin() + size_t(last + 1) * size_t(settings.numCoefficients), t.features.end());
+        t.features.erase(t.features.begin(), t.features.begin() + size_t(first) * size_t(settings.numCoefficients));
+
+        clearPaths(t);
+        templates.push_back(std::move(t));
+        return true;
+    }
+
+    void clearTemplates() noexcept { templates.clear(); }
+
+    /** Feeds one frame of getFrameSize() samples.
+        @returns true if a template match ends on this frame
+    */
+    bool processFrame(const short* frame, int numSamples)
+    {
+        if (numSamples < frameSize || templates.empty())
+            return false;
+
+        computeFeatures(live, frame, frameFeatures.data());
+        ++frameIndex;
+
+        float best = std::numeric_limits<float>::max();
+        for (auto& t : templates)
+            best = std::min(best, advance(t, frameFeatures.data()));
+
+        lastScore = best;
+
+        if (refractoryFrames > 0)
+        {
+            --refractoryFrames;
+            return false;
+        }
+
+        //Fires once the best match so far has stood for settleMs, or the score is back over threshold
+        if (best <= settings.threshold && best < candidateScore)
+        {
+            candidateScore = best;
+            candidateAge = 0;
+            return false;
+        }
+
+        if (candidateScore > settings.threshold)
+            return false;
+
+        if (best <= settings.threshold && ++candidateAge < settings.settleMs / settings.frameMs)
+            return false;
+
+        //Starts every path afresh so the same utterance can't fire twice
+        candidateScore = std::numeric_limits<float>::max();
+        refractoryFrames = settings.refractoryMs / settings.frameMs;
+        for (auto& t : templates)
+            clearPaths(t);
+
+        return true;
+    }
+
+    /** The best template's score on the last frame, lower is closer */
+    float getLastScore() const noexcept { return lastScore; }
+
+private:
+    /** Front end state carried from one frame to the next */
+    struct Analysis
+    {
+        std::vector<float> history;
+        float previousSample = 0.0f;
+    };
+
+    void resetAnalysis(Analysis& analysis) const
+    {
+        analysis.history.assign(size_t(windowSize), 0.0f);
+        analysis.previousSample = 0.0f;
+    }
+
+    struct Cell
+    {
+        float cost = std::numeric_limits<float>::max();
+        int length = 0;
+        int start = 0;
+
+        float mean() const noexcept { return length > 0 ? cost / float(length) : std::numeric_limits<float>::max(); }
+    };
+
+    struct Template
+    {
+        std::vector<float> features;
+        int numFrames = 0;
+        std::vector<Cell> previous, current;
+    };
+
+    static void clearPaths(Template& t)
+    {
+        t.previous.assign(size_t(t.numFrames), Cell());
+        t.current.assign(size_t(t.numFrames), Cell());
+    }
+
+    /** Extends every path of t by one query frame, returns the score of the path ending on its last frame */
+    float advance(Template& t, const float* x) const noexcept
+    {
+        const int numCoefficients = settings.numCoefficients;
+
+        for (int j = 0; j < t.numFrames; ++j)
+        {
+            const float* y = t.features.data() + size_t(j) * size_t(numCoefficients);
+
+            float sumOfSquares = 0.0f;
+            for (int c = 0; c < numCoefficients; ++c)
+                sumOfSquares += (x[c] - y[c]) * (x[c] - y[c]);
+
+            const float distance = std::sqrt(sumOfSquares);
+
+            //Diagonal, query only and template only steps, a template may start on any frame
+            Cell from;
+            if (j == 0)
+            {
+                from.cost = 0.0f;
+                from.start = frameIndex;
+            }
+            else
+            {
+                from = t.previous[size_t(j - 1)];
+            }
+
+            //Compared on the mean the path would have after this step, so a fresh start can win
+            auto meanAfterStep = [distance](const Cell& c) { return (c.cost + distance) / float(c.length + 1); };
+
+            if (t.previous[size_t(j)].length > 0 && meanAfterStep(t.previous[size_t(j)]) < meanAfterStep(from))
+                from = t.previous[size_t(j)];
+            if (j > 0 && t.current[size_t(j - 1)].length > 0 && meanAfterStep(t.current[size_t(j - 1)]) < meanAfterStep(from))
+                from = t.current[size_t(j - 1)];
+
+            if (from.length == 0 && j > 0)
+            {
+                t.current[size_t(j)] = Cell();
+                continue;
+            }
+
+            Cell& cell = t.current[size_t(j)];
+            cell.cost = from.cost + distance;
+            cell.length = from.length + 1;
+            cell.start = from.start;
+        }
+
+        std::swap(t.previous, t.current);
+
+        const Cell& end = t.previous[size_t(t.numFrames - 1)];
+        const int span = frameIndex - end.start + 1;
+
+        if (span * settings.maxWarp < float(t.numFrames) || float(span) > float(t.numFrames) * settings.maxWarp)
+            return std::numeric_limits<float>::max();
+
+        return end.mean();
+    }
+
+    //==============================================================================
+    /** Writes the normalised log mel spectrum of the window ending with frame, returns its level in dB */
+    float computeFeatures(Analysis& analysis, const short* frame, float* features)
+    {
+        auto& history = analysis.history;
+
+        //Slide the analysis window along by one frame
+        std::memmove(history.data(), history.data() + frameSize, sizeof(float) * size_t(windowSize - frameSize));
+        for (int i = 0; i < frameSize; ++i)
+        {
+            const float sample = float(frame[i]) * (1.0f / 32768.0f);
+            history[size_t(windowSize - frameSize + i)] = sample - 0.97f * analysis.previousSample;
+            analysis.previousSample = sample;
+        }
+
+        for (int i = 0; i < fftSize; ++i)
+            spectrum[size_t(i)] = std::complex<float>(i < windowSize ? history[size_t(i)] * window[size_t(i)] : 0.0f, 0.0f);
+
+        fft(spectrum);
+
+        float totalPower = 0.0f;
+        for (int band = 0; band < settings.numBands; ++band)
+        {
+            const auto& filter = filters[size_t(band)];
+
+            float power = 0.0f;
+            for (size_t k = 0; k < filter.weights.size(); ++k)
+                power += filter.weights[k] * std::norm(spectrum[size_t(filter.firstBin) + k]);
+
+            totalPower += power;
+            logEnergies[size_t(band)] = std::log(power + 1.0e-10f);
+        }
+
+        //Cepstrum without c0, which only carries the level
+        for (int c = 0; c < settings.numCoefficients; ++c)
+        {
+            const float* basis = dct.data() + size_t(c) * size_t(settings.numBands);
+
+            float sum = 0.0f;
+            for (int band = 0; band < settings.numBands; ++band)
+                sum += basis[band] * logEnergies[size_t(band)];
+
+            features[c] = sum;
+        }
+
+        return 10.0f * std::log10(totalPower + 1.0e-10f);
+    }
+
+    void prepareFft()
+    {
+        const float pi = 3.14159265358979f;
+
+        spectrum.assign(size_t(fftSize), 0.0f);
+
+        window.resize(size_t(windowSize));
+        for (int i = 0; i < windowSize; ++i)
+            window[size_t(i)] = 0.5f - 0.5f * std::cos(2.0f * pi * float(i) / float(windowSize - 1));
+
+        twiddles.resize(size_t(fftSize / 2));
+        for (int i = 0; i < fftSize / 2; ++i)
+            twiddles[size_t(i)] = std::polar(1.0f, -2.0f * pi * float(i) / float(fftSize));
+    }
+
+    void prepareFilterbank()
+    {
+        auto toMel = [](float hz) { return 2595.0f * std::log10(1.0f + hz / 700.0f); };
+        auto toHz = [](float mel) { return 700.0f * (std::pow(10.0f, mel / 2595.0f) - 1.0f); };
+
+        const float highestHz = std::min(settings.highestHz, settings.sampleRate * 0.5f);
+        const float lowMel = toMel(settings.lowestHz), highMel = toMel(highestHz);
+        const float binHz = float(settings.sampleRate) / float(fftSize);
+
+        //Band edges in bins, band b rises from edge b to b + 1 and falls to b + 2
+        std::vector<float> edges(size_t(settings.numBands + 2));
+        for (size_t i = 0; i < edges.size(); ++i)
+            edges[i] = toHz(lowMel + (highMel - lowMel) * float(i) / float(settings.numBands + 1)) / binHz;
+
+        filters.assign(size_t(settings.numBands), Filter());
+        for (int band = 0; band < settings.numBands; ++band)
+        {
+            const float left = edges[size_t(band)], centre = edges[size_t(band + 1)], right = edges[size_t(band + 2)];
+            auto& filter = filters[size_t(band)];
+
+            filter.firstBin = std::max(0, (int)std::ceil(left));
+            const int lastBin = std::min(fftSize / 2, (int)std::floor(right));
+
+            for (int bin = filter.firstBin; bin <= lastBin; ++bin)
+            {
+                const float weight = bin <= centre ? (bin - left) / std::max(centre - left, 1.0e-3f)
+                                                   : (right - bin) / std::max(right - centre, 1.0e-3f);
+                filter.weights.push_back(std::max(0.0f, weight));
+            }
+
+            //Narrow low bands can fall between bins, give them the nearest one
+            if (filter.weights.empty())
+            {
+                filter.firstBin = std::min(fftSize / 2, (int)std::lround(centre));
+                filter.weights.push_back(1.0f);
+            }
+        }
+
+        logEnergies.resize(size_t(settings.numBands));
+        frameFeatures.resize(size_t(settings.numCoefficients));
+
+        //DCT-II rows 1 to numCoefficients, orthonormal
+        const float pi = 3.14159265358979f;
+        dct.resize(size_t(settings.numCoefficients) * size_t(settings.numBands));
+        for (int c = 0; c < settings.numCoefficients; ++c)
+            for (int band = 0; band < settings.numBands; ++band)
+                dct[size_t(c * settings.numBands + band)] = std::sqrt(2.0f / float(settings.numBands))
+                                                            * std::cos(pi * float(c + 1) * (float(band) + 0.5f) / float(settings.numBands));
+    }
+
+    /** In place radix 2 FFT */
+    void fft(std::vector<std::complex<float>>& data) const noexcept
+    {
+        const int n = fftSize;
+
+        for (int i = 1, j = 0; i < n; ++i)
+        {
+            int bit = n >> 1;
+            for (; j & bit; bit >>= 1)
+                j ^= bit;
+            j ^= bit;
+
+            if (i < j)
+                std::swap(data[size_t(i)], data[size_t(j)]);
+        }
+
+        for (int length = 2; length <= n; length <<= 1)
+        {
+            const int half = length / 2, stride = n / length;
+
+            for (int start = 0; start < n; start += length)
+            {
+                for (int k = 0; k < half; ++k)
+                {
+                    const auto t = twiddles[size_t(k * stride)] * data[size_t(start + k + half)];
+                    data[size_t(start + k + half)] = data[size_t(start + k)] - t;
+                    data[size_t(start + k)] += t;
+                }
+            }
+        }
+    }
+
+    struct Filter
+    {
+        int firstBin = 0;
+        std::vector<float> weights;
+    };
+
+    Settings settings;
+    int frameSize = 160, windowSize = 400, fftSize = 512;
+
+    Analysis live;
+
+    std::vector<float> window, logEnergies, dct, frameFeatures;
+    std::vector<std::complex<float>> spectrum, twiddles;
+    std::vector<Filter> filters;
+
+    std::vector<Template> templates;
+    int frameIndex = 0;
+    int refractoryFrames = 0;
+    float lastScore = std::numeric_limits<float>::max();
+    float candidateScore = std::numeric_limits<float>::max();
+    int candidateAge = 0;
+};
@@ -0,0 +1,448 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <numeric>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define GENISYS_LEVELMETER_SSE 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define GENISYS_LEVELMETER_NEON 1
+#endif
+
+//==============================================================================
+/** MeterKernels - peak and sum of squares of a block in a single pass.
+
+    Reading a block once for the peak and again for the RMS touches every
+    sample twice. These collect both in one sweep, with SSE2 or NEON where the
+    compiler targets them. Squares are summed in float lanes and flushed into a
+    double every 1024 samples, so the result stays within rounding of a plain
+    double sum. Shared by InputLevelMeter and the ff_meters GUI module.
+*/
+struct MeterKernels
+{
+    /** Finds the largest absolute value and the sum of squares of num samples */
+    static void findPeakAndSumOfSquares(const float* src, int num, float& peak, double& sumOfSquares) noexcept
+    {
+        sweep<1>(&src, num, &peak, &sumOfSquares);
+    }
+
+    static void findPeakAndSumOfSquares(const double* src, int num, double& peak, double& sumOfSquares) noexcept
+    {
+        double p = 0.0, sum = 0.0;
+        for (int i = 0; i < num; ++i)
+        {
+            p = std::max(p, std::abs(src[i]));
+            sum += src[i] * src[i];
+        }
+        peak = p;
+        sumOfSquares = sum;
+    }
+
+    /** Finds the peak and the sum of squares of every channel. Channels are walked
+        in pairs, which keeps twice the accumulators in flight for short blocks.
+        @param peaks receives numChannels peaks
+        @param sumsOfSquares receives numChannels sums
+    */
+    static void findPeakAndSumOfSquares(const float* const* channels, int numChannels, int num,
+                                        float* peaks, double* sumsOfSquares) noexcept
+    {
+        int channel = 0;
+        for (; channel + 2 <= numChannels; channel += 2)
+            sweep<2>(channels + channel, num, peaks + channel, sumsOfSquares + channel);
+
+        if (channel < numChannels)
+            sweep<1>(channels + channel, num, peaks + channel, sumsOfSquares + channel);
+    }
+
+    static void findPeakAndSumOfSquares(const double* const* channels, int numChannels, int num,
+                                        double* peaks, double* sumsOfSquares) noexcept
+    {
+        for (int channel = 0; channel < numChannels; ++channel)
+            findPeakAndSumOfSquares(channels[channel], num, peaks[channel], sumsOfSquares[channel]);
+    }
+
+private:
+    static constexpr int flushInterval = 1024;
+
+    template <int numChannels>
+    static void sweep(const float* const* channels, const int num, float* peaks, double* sums) noexcept
+    {
+        int start = 0;
+        double total[numChannels] = {};
+        float peak[numChannels] = {};
+
+#if GENISYS_LEVELMETER_SSE
+        const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+        __m128 peakA[numChannels], peakB[numChannels];
+        for (int c = 0; c < numChannels; ++c)
+            peakA[c] = peakB[c] = _mm_setzero_ps();
+
+        for (const int vectorEnd = num & ~7; start < vectorEnd;)
+        {
+            const int chunkEnd = std::min(start + flushInterval, vectorEnd);
+
+            __m128 squareA[numChannels], squareB[numChannels];
+            for (int c = 0; c < numChannels; ++c)
+                squareA[c] = squareB[c] = _mm_setzero_ps();
+
+            for (int i = start; i < chunkEnd; i += 8)
+            {
+                for (int c = 0; c < numChannels; ++c)
+                {
+                    const __m128 a = _mm_loadu_ps(channels[c] + i);
+                    const __m128 b = _mm_loadu_ps(channels[c] + i + 4);
+                    peakA[c] = _mm_max_ps(peakA[c], _mm_and_ps(a, absMask));
+                    peakB[c] = _mm_max_ps(peakB[c], _mm_and_ps(b, absMask));
+                    squareA[c] = _mm_add_ps(squareA[c], _mm_mul_ps(a, a));
+                    squareB[c] = _mm_add_ps(squareB[c], _mm_mul_ps(b, b));
+                }
+            }
+
+            for (int c = 0; c < numChannels; ++c)
+            {
+                alignas(16) float lanes[4];
+                _mm_store_ps(lanes, _mm_add_ps(squareA[c], squareB[c]));
+                total[c] += double(lanes[0]) + double(lanes[1]) + double(lanes[2]) + double(lanes[3]);
+            }
+
+            start = chunkEnd;
+        }
+
+        for (int c = 0; c < numChannels; ++c)
+        {
+            alignas(16) float lanes[4];
+            _mm_store_ps(lanes, _mm_max_ps(peakA[c], peakB[c]));
+            peak[c] = std::max(std::max(lanes[0], lanes[1]), std::max(lanes[2], lanes[3]));
+        }
+#elif GENISYS_LEVELMETER_NEON
+        float32x4_t peakA[numChannels], peakB[numChannels];
+        for (int c = 0; c < numChannels; ++c)
+            peakA[c] = peakB[c] = vdupq_n_f32(0.0f);
+
+        for (const int vectorEnd = num & ~7; start < vectorEnd;)
+        {
+            const int chunkEnd = std::min(start + flushInterval, vectorEnd);
+
+            float32x4_t squareA[numChannels], squareB[numChannels];
+            for (int c = 0; c < numChannels; ++c)
+                squareA[c] = squareB[c] = vdupq_n_f32(0.0f);
+
+            for (int i = start; i < chunkEnd; i += 8)
+            {
+                for (int c = 0; c < numChannels; ++c)
+                {
+                    const float32x4_t a = vld1q_f32(channels[c] + i);
+                    const float32x4_t b = vld1q_f32(channels[c] + i + 4);
+                    peakA[c] = vmaxq_f32(peakA[c], vabsq_f32(a));
+                    peakB[c] = vmaxq_f32(peakB[c], vabsq_f32(b));
+                    squareA[c] = vaddq_f32(squareA[c], vmulq_f32(a, a));
+                    squareB[c] = vaddq_f32(squareB[c], vmulq_f32(b, b));
+                }
+            }
+
+            for (int c = 0; c < numChannels; ++c)
+            {
+                float lanes[4];
+                vst1q_f32(lanes, vaddq_f32(squareA[c], squareB[c]));
+                total[c] += double(lanes[0]) + double(lanes[1]) + double(lanes[2]) + double(lanes[3]);
+            }
+
+            start = chunkEnd;
+        }
+
+        for (int c = 0; c < numChannels; ++c)
+        {
+            float lanes[4];
+            vst1q_f32(lanes, vmaxq_f32(peakA[c], peakB[c]));
+            peak[c] = std::max(std::max(lanes[0], lanes[1]), std::max(lanes[2], lanes[3]));
+        }
+#endif
+
+        for (int c = 0; c < numChannels; ++c)
+        {
+            const float* src = channels[c];
+            for (int i = start; i < num; ++i)
+            {
+                const float sample = src[i];
+                peak[c] = std::max(peak[c], std::abs(sample));
+                total[c] += sample * sample;
+            }
+
+            peaks[c] = peak[c];
+            sums[c] = total[c];
+        }
+    }
+};
+
+//==============================================================================
+/** RunningMeanSquare - the mean of the last N mean squares in constant time.
+
+    Each push adds the new value to a running sum and takes out the one it
+    replaces. Adding and subtracting leaves rounding errors behind, so the sum
+    is rebuilt from the ring once per lap. One thread pushes, any thread may
+    call get(), which reads the mean published by the last push.
+*/
+class RunningMeanSquare
+{
+public:
+    RunningMeanSquare() = default;
+
+    /** Sets the number of values averaged and clears them. This allocates. */
+    void setSize(size_t numValues)
+    {
+        history.assign(numValues, 0.0);
+        reset();
+    }
+
+    size_t getSize() const noexcept { return history.size(); }
+
+    void reset() noexcept
+    {
+        std::fill(history.begin(), history.end(), 0.0);
+        runningSum = 0.0;
+        position = 0;
+        mean.store(0.0, std::memory_order_relaxed);
+    }
+
+    void push(double meanSquare) noexcept
+    {
+        const size_t numValues = history.size();
+
+        if (numValues == 0)
+        {
+            mean.store(meanSquare, std::memory_order_relaxed);
+            return;
+        }
+
+        runningSum += meanSquare - history[position];
+        history[position] = meanSquare;
+
+        if (++position == numValues)
+        {
+            position = 0;
+            runningSum = std::accumulate(history.begin(), history.end(), 0.0);
+        }
+
+        mean.store(std::max(0.0, runningSum) / double(numValues), std::memory_order_relaxed);
+    }
+
+    double get() const noexcept { return mean.load(std::memory_order_relaxed); }
+
+private:
+    // writer only, readers see mean
+    std::vector<double> history;
+    double runningSum = 0.0;
+    size_t position = 0;
+
+    std::atomic<double> mean { 0.0 };
+};
+
+//==============================================================================
+/** InputLevelMeter - peak, RMS, clipping and noise floor of a mono signal, without a GUI.
+
+    Samples are measured in frames of frameMs. At the end of each frame the
+    peak hold, the RMS window and the noise floor move on and the results are
+    published through atomics, so getLevels() may be called from any thread
+    while a single thread calls process(). No timer or repaint is involved:
+    the meter only advances as audio arrives.
+
+    The noise floor is the minimum of the smoothed frame energy over the last
+    noiseFloorWindowMs. Speech leaves gaps within a few seconds, so the minimum
+    sits on the background between them. The minimum is kept per sub-window,
+    which lets the floor follow a rising background once the sub-windows
+    holding the quieter past have moved out.
+*/
+class InputLevelMeter
+{
+public:
+    struct Settings
+    {
+        int sampleRate = 16000;
+        int frameMs = 10;
+        int rmsWindowMs = 300;              /**< RMS is the mean over this span of frames */
+        int peakHoldMs = 1500;              /**< A peak is held this long before it follows the signal again */
+        float clipLevel = 1.0f;             /**< Samples with a magnitude at or above this count as clipped */
+        int noiseFloorWindowMs = 5000;      /**< The floor is the quietest moment of this span */
+    };
+
+    struct Levels
+    {
+        float peak = 0.0f;                  /**< Held peak magnitude, 1.0 is full scale */
+        float maxPeak = 0.0f;               /**< Largest magnitude since reset */
+        float rms = 0.0f;
+        float noiseFloorDb = -100.0f;       /**< dB relative to a full scale square wave */
+        uint64_t clippedSamples = 0;
+        uint64_t numSamples = 0;            /**< Samples measured since reset */
+    };
+
+    InputLevelMeter() { setSettings(Settings()); }
+
+    /** Applies the settings and clears the readings. This allocates. */
+    void setSettings(const Settings& newSettings)
+    {
+        settings = newSettings;
+        rmsWindow.setSize(size_t(std::max(1, settings.rmsWindowMs / std::max(1, settings.frameMs))));
+        floorMinima.resize(numFloorSubWindows);
+        framesPerFloorSubWindow = std::max(1, settings.noiseFloorWindowMs / std::max(1, settings.frameMs) / int(numFloorSubWindows));
+        setSampleRate(settings.sampleRate);
+        reset();
+    }
+
+    const Settings& getSettings() const noexcept { return settings; }
+
+    /** Changes the rate of the samples to come without allocating or clearing the readings */
+    void setSampleRate(int sampleRate) noexcept
+    {
+        settings.sampleRate = sampleRate;
+        frameSize = std::max(1, sampleRate * settings.frameMs / 1000);
+    }
+
+    void reset() noexcept
+    {
+        rmsWindow.reset();
+        framePeak = 0.0f;
+        frameSumOfSquares = 0.0;
+        frameFill = 0;
+        heldPeak = 0.0f;
+        holdFramesLeft = 0;
+        smoothedDb = 0.0f;
+        haveSmoothedDb = false;
+        std::fill(floorMinima.begin(), floorMinima.end(), float(noMinimum));
+        floorSubWindow = 0;
+        floorSubWindowFrames = 0;
+        floorSubWindowMinimum = noMinimum;
+        clipCount = 0;
+        sampleCount = 0;
+
+        peak.store(0.0f, std::memory_order_relaxed);
+        maxPeak.store(0.0f, std::memory_order_relaxed);
+        noiseFloorDb.store(-100.0f, std::memory_order_relaxed);
+        clippedSamples.store(0, std::memory_order_relaxed);
+        numSamples.store(0, std::memory_order_relaxed);
+    }
+
+    /** Measures a block. Never allocates or locks, so it may run on an audio thread. */
+    void process(const float* samples, int num) noexcept
+    {
+        for (int offset = 0; offset < num;)
+        {
+            const int chunk = std::min(num - offset, std::max(1, frameSize - frameFill));
+
+            float chunkPeak;
+            double chunkSumOfSquares;
+            MeterKernels::findPeakAndSumOfSquares(samples + offset, chunk, chunkPeak, chunkSumOfSquares);
+
+            // Only blocks that reach the clip level are counted sample by sample
+            if (chunkPeak >= settings.clipLevel)
+                for (int i = offset; i < offset + chunk; ++i)
+                    clipCount += std::abs(samples[i]) >= settings.clipLevel ? 1 : 0;
+
+            framePeak = std::max(framePeak, chunkPeak);
+            frameSumOfSquares += chunkSumOfSquares;
+            frameFill += chunk;
+            offset += chunk;
+
+            if (frameFill >= frameSize)
+                FinishFrame();
+        }
+
+        sampleCount += uint64_t(std::max(0, num));
+        clippedSamples.store(clipCount, std::memory_order_relaxed);
+        numSamples.store(sampleCount, std::memory_order_relaxed);
+    }
+
+    /** Reads the levels published by the last complete frame, from any thread */
+    Levels getLevels() const noexcept
+    {
+        Levels levels;
+        levels.peak = peak.load(std::memory_order_relaxed);
+        levels.maxPeak = maxPeak.load(std::memory_order_relaxed);
+        levels.rms = float(std::sqrt(rmsWindow.get()));
+        levels.noiseFloorDb = noiseFloorDb.load(std::memory_order_relaxed);
+        levels.clippedSamples = clippedSamples.load(std::memory_order_relaxed);
+        levels.numSamples = numSamples.load(std::memory_order_relaxed);
+        return levels;
+    }
+
+private:
+    void FinishFrame() noexcept
+    {
+        const double meanSquare = frameSumOfSquares / double(frameFill);
+        rmsWindow.push(meanSquare);
+
+        if (framePeak >= heldPeak || holdFramesLeft <= 0)
+        {
+            if (framePeak >= heldPeak)
+                holdFramesLeft = settings.peakHoldMs / std::max(1, settings.frameMs);
+
+            heldPeak = framePeak;
+        }
+        else
+        {
+            --holdFramesLeft;
+        }
+
+        // Same scale as Endpointer::getEnergyDb, a full scale square wave is 0dB
+        // Smoothed over a few frames, so a single quiet frame between words doesn't pull the floor down
+        const float energyDb = float(10.0 * std::log10(meanSquare + 1.0e-10));
+        smoothedDb = haveSmoothedDb ? smoothedDb + (energyDb - smoothedDb) * 0.2f : energyDb;
+        haveSmoothedDb = true;
+
+        floorSubWindowMinimum = std::min(floorSubWindowMinimum, smoothedDb);
+        float floorDb = floorSubWindowMinimum;
+        for (const float minimum : floorMinima)
+            floorDb = std::min(floorDb, minimum);
+
+        if (++floorSubWindowFrames == framesPerFloorSubWindow)
+        {
+            floorMinima[floorSubWindow] = floorSubWindowMinimum;
+            floorSubWindow = (floorSubWindow + 1) % floorMinima.size();
+            floorSubWindowFrames = 0;
+            floorSubWindowMinimum = noMinimum;
+        }
+
+        peak.store(heldPeak, std::memory_order_relaxed);
+        maxPeak.store(std::max(maxPeak.load(std::memory_order_relaxed), framePeak), std::memory_order_relaxed);
+        noiseFloorDb.store(floorDb, std::memory_order_relaxed);
+
+        framePeak = 0.0f;
+        frameSumOfSquares = 0.0;
+        frameFill = 0;
+    }
+
+    static constexpr size_t numFloorSubWindows = 8;
+    static constexpr float noMinimum = 1000.0f;
+
+    Settings settings;
+    int frameSize = 160;
+    int framesPerFloorSubWindow = 62;
+
+    // writer only
+    RunningMeanSquare rmsWindow;
+    float framePeak = 0.0f;
+    double frameSumOfSquares = 0.0;
+    int frameFill = 0;
+    float heldPeak = 0.0f;
+    int holdFramesLeft = 0;
+    float smoothedDb = 0.0f;
+    bool haveSmoothedDb = false;
+    std::vector<float> floorMinima;
+    size_t floorSubWindow = 0;
+    int floorSubWindowFrames = 0;
+    float floorSubWindowMinimum = noMinimum;
+    uint64_t clipCount = 0;
+    uint64_t sampleCount = 0;
+
+    // published for readers
+    std::atomic<float> peak { 0.0f };
+    std::atomic<float> maxPeak { 0.0f };
+    std::atomic<float> noiseFloorDb { -100.0f };
+    std::atomic<uint64_t> clippedSamples { 0 };
+    std::atomic<uint64_t> numSamples { 0 };
+};
@@ -0,0 +1,274 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define GENISYS_POLYPHASE_SSE 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define GENISYS_POLYPHASE_NEON 1
+#endif
+
+//==============================================================================
+/** PolyphaseResampler - fixed ratio resampler built on a precomputed polyphase FIR.
+
+    The ratio is reduced to upFactor:downFactor (48000 to 16000 is 1:3, 44100 to
+    16000 is 160:441) and a Kaiser windowed sinc is designed once for it, split
+    into upFactor phases stored back to front. Each output sample is then a
+    single float dot product between one phase and the newest input samples,
+    with no per-sample coefficient interpolation.
+
+    Only ratios between integer rates are supported, and upFactor is bounded
+    by maxUpFactor to keep the coefficient table small.
+*/
+class PolyphaseResampler
+{
+public:
+    struct Settings
+    {
+        float bandwidth = 0.8f;         /**< Passband edge as a fraction of the lower Nyquist frequency */
+        float attenuationDb = 96.0f;    /**< Stopband attenuation */
+        int maxUpFactor = 512;
+    };
+
+    PolyphaseResampler() = default;
+
+    void setSettings(const Settings& newSettings) { settings = newSettings; }
+    const Settings& getSettings() const noexcept { return settings; }
+
+    /** Designs the filter for inputRate to outputRate.
+        @returns false if the reduced ratio needs more than maxUpFactor phases
+    */
+    bool setRates(int inputRate, int outputRate)
+    {
+        if (inputRate <= 0 || outputRate <= 0)
+            return false;
+
+        const int divisor = gcd(inputRate, outputRate);
+        const int up = outputRate / divisor;
+        const int down = inputRate / divisor;
+
+        if (up > settings.maxUpFactor)
+            return false;
+
+        //The defaults are 1:1 too, so a pass through ratio still needs its first design
+        if (up == upFactor && down == downFactor && designed)
+            return true;
+
+        upFactor = up;
+        downFactor = down;
+        designFilter();
+        designed = true;
+        setSize(numChannels, maxBlockSize);
+        return true;
+    }
+
+    /** Allocates the per channel history, must be called before process(). */
+    void setSize(int numCh, int maxBlock)
+    {
+        numChannels = std::max(0, numCh);
+        maxBlockSize = std::max(0, maxBlock);
+
+        history.resize(size_t(numChannels));
+
+        for (auto& channel : history)
+            channel.assign(size_t(numTaps - 1 + maxBlockSize), 0.0f);
+
+        reset();
+    }
+
+    void reset() noexcept
+    {
+        for (auto& channel : history)
+            std::fill(channel.begin(), channel.end(), 0.0f);
+
+        numBuffered = numTaps - 1;
+        position = numTaps - 1;
+        phase = 0;
+    }
+
+    int getUpFactor() const noexcept { return upFactor; }
+    int getDownFactor() const noexcept { return downFactor; }
+    int getNumTapsPerPhase() const noexcept { return numTaps; }
+
+    /** Upper bound on the samples process() returns for numInput samples. */
+    int getMaxOutputSamples(int numInput) const noexcept
+    {
+        return int((long long)numInput * upFactor / downFactor) + 1;
+    }
+
+    /** Resamples up to maxBlockSize samples per channel.
+        maxOutput should be at least getMaxOutputSamples(numInput), input the output
+        has no room for stays buffered and reduces what the next call accepts.
+        @returns the number of samples written to each output channel, at most maxOutput
+    */
+    int process(const float* const* input, int numInput, float* const* output, int maxOutput) noexcept
+    {
+        numInput = std::min(numInput, numTaps - 1 + maxBlockSize - numBuffered);
+
+        for (int ch = 0; ch < numChannels; ++ch)
+            std::memcpy(history[size_t(ch)].data() + numBuffered, input[ch], sizeof(float) * size_t(numInput));
+
+        numBuffered += numInput;
+
+        int numOutput = 0;
+        int channelPosition = position, channelPhase = phase;
+
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            const float* samples = history[size_t(ch)].data();
+            float* dest = output[ch];
+
+            channelPosition = position;
+            channelPhase = phase;
+            numOutput = 0;
+
+            while (channelPosition < numBuffered && numOutput < maxOutput)
+            {
+                dest[numOutput++] = dotProduct(coefficients.data() + size_t(channelPhase) * size_t(numTaps),
+                                               samples + channelPosition - (numTaps - 1),
+                                               numTaps);
+
+                channelPhase += downFactor;
+                channelPosition += channelPhase / upFactor;
+                channelPhase %= upFactor;
+            }
+        }
+
+        position = channelPosition;
+        phase = channelPhase;
+
+        //Keep only the samples the next outputs still reach back to
+        const int discard = std::min(position - (numTaps - 1), numBuffered);
+
+        if (discard > 0)
+        {
+            for (auto& channel : history)
+                std::memmove(channel.data(), channel.data() + discard, sizeof(float) * size_t(numBuffered - discard));
+
+            numBuffered -= discard;
+            position -= discard;
+        }
+
+        return numOutput;
+    }
+
+    static float dotProduct(const float* a, const float* b, int num) noexcept
+    {
+        int i = 0;
+        float sum = 0.0f;
+
+#if GENISYS_POLYPHASE_SSE
+        __m128 acc0 = _mm_setzero_ps(), acc1 = _mm_setzero_ps();
+
+        for (; i + 8 <= num; i += 8)
+        {
+            acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+            acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_loadu_ps(a + i + 4), _mm_loadu_ps(b + i + 4)));
+        }
+
+        float lanes[4];
+        _mm_storeu_ps(lanes, _mm_add_ps(acc0, acc1));
+        sum = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+#elif GENISYS_POLYPHASE_NEON
+        float32x4_t acc0 = vdupq_n_f32(0.0f), acc1 = vdupq_n_f32(0.0f);
+
+        for (; i + 8 <= num; i += 8)
+        {
+            acc0 = vmlaq_f32(acc0, vld1q_f32(a + i), vld1q_f32(b + i));
+            acc1 = vmlaq_f32(acc1, vld1q_f32(a + i + 4), vld1q_f32(b + i + 4));
+        }
+
+        float lanes[4];
+        vst1q_f32(lanes, vaddq_f32(acc0, acc1));
+        sum = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+#endif
+
+        for (; i < num; ++i)
+            sum += a[i] * b[i];
+
+        return sum;
+    }
+
+private:
+    static int gcd(int a, int b) noexcept
+    {
+        while (b != 0)
+        {
+            const int t = a % b;
+            a = b;
+            b = t;
+        }
+
+        return a;
+    }
+
+    static double besselI0(double x) noexcept
+    {
+        double sum = 1.0, term = 1.0;
+        const double halfX = x * 0.5;
+
+        for (int k = 1; k < 64 && term > sum * 1.0e-12; ++k)
+        {
+            term *= (halfX / k) * (halfX / k);
+            sum += term;
+        }
+
+        return sum;
+    }
+
+    void designFilter()
+    {
+        const double pi = 3.14159265358979323846;
+
+        //Frequencies in cycles per sample at the input rate
+        const double nyquist = 0.5 * std::min(1.0, double(upFactor) / double(downFactor));
+        const double passband = nyquist * settings.bandwidth;
+        const double transition = std::max(nyquist - passband, 1.0e-4);
+
+        //Kaiser's estimates for the window length and shape
+        const double attenuation = std::max(21.0, double(settings.attenuationDb));
+        const double beta = attenuation > 50.0 ? 0.1102 * (attenuation - 8.7)
+                                               : 0.5842 * std::pow(attenuation - 21.0, 0.4) + 0.07886 * (attenuation - 21.0);
+
+        numTaps = int(std::ceil((attenuation - 7.95) / (14.36 * transition))) + 1;
+        numTaps = (numTaps + 7) & ~7;
+
+        //The prototype runs at the upsampled rate, cutoff centred in the transition band
+        const int length = numTaps * upFactor;
+        const double cutoff = (passband + nyquist) * 0.5 / upFactor;
+        const double centre = 0.5 * (length - 1);
+        const double windowNorm = 1.0 / besselI0(beta);
+
+        std::vector<double> prototype((size_t)length);
+
+        for (int k = 0; k < length; ++k)
+        {
+            const double t = k - centre;
+            const double sinc = t == 0.0 ? 2.0 * cutoff : std::sin(2.0 * pi * cutoff * t) / (pi * t);
+            const double r = t / (0.5 * length);
+            const double window = besselI0(beta * std::sqrt(std::max(0.0, 1.0 - r * r))) * windowNorm;
+
+            prototype[size_t(k)] = sinc * window * upFactor;
+        }
+
+        //Phase p holds taps p, p + upFactor, ... reversed so they line up with the oldest sample first
+        coefficients.assign(size_t(length), 0.0f);
+
+        for (int p = 0; p < upFactor; ++p)
+            for (int j = 0; j < numTaps; ++j)
+                coefficients[size_t(p * numTaps + (numTaps - 1 - j))] = float(prototype[size_t(p + j * upFactor)]);
+    }
+
+    Settings settings;
+    int upFactor = 1, downFactor = 1, numTaps = 8;
+    bool designed = false;
+    int numChannels = 0, maxBlockSize = 0;
+    int numBuffered = 0, position = 0, phase = 0;
+    std::vector<float> coefficients = std::vector<float>(8, 0.0f);
+    std::vector<std::vector<float>> history;
+};
@@ -0,0 +1,137 @@
+#pragma once
+
+#include <algorithm>
+#include <assert.h>
+#include <atomic>
+
+//==============================================================================
+/** SpscFifo - index bookkeeping for a single producer, single consumer ring.
+
+    A drop in replacement for juce::AbstractFifo with the same prepare/finished
+    interface and the same capacity (one slot is always left empty). The write
+    index and the producer's state live on one cache line, the read index and
+    the consumer's state on another, so the two threads don't keep stealing a
+    shared line from each other. Each side publishes its index with a release
+    store and only reloads the other side's index, with an acquire load, when
+    its cached copy says there isn't enough room or data.
+
+    prepareToWrite/finishedWrite must only be called by the producer and
+    prepareToRead/finishedRead only by the consumer. reset() and
+    setTotalSize() are not thread safe.
+*/
+class SpscFifo
+{
+public:
+    explicit SpscFifo(int capacity) noexcept
+    {
+        assert(capacity > 0);
+        producer.size = consumer.size = capacity;
+    }
+
+    int getTotalSize() const noexcept { return producer.size; }
+    int getFreeSpace() const noexcept { return getTotalSize() - getNumReady() - 1; }
+
+    int getNumReady() const noexcept
+    {
+        const int start = consumer.index.load(std::memory_order_acquire);
+        const int end = producer.index.load(std::memory_order_acquire);
+        return getNumReady(start, end, getTotalSize());
+    }
+
+    void reset() noexcept
+    {
+        producer.index.store(0, std::memory_order_relaxed);
+        consumer.index.store(0, std::memory_order_relaxed);
+        producer.cachedOtherIndex = 0;
+        consumer.cachedOtherIndex = 0;
+    }
+
+    void setTotalSize(int newSize) noexcept
+    {
+        assert(newSize > 0);
+        reset();
+        producer.size = consumer.size = newSize;
+    }
+
+    //==============================================================================
+    /** Producer side, see juce::AbstractFifo::prepareToWrite */
+    void prepareToWrite(int numToWrite, int& startIndex1, int& blockSize1, int& startIndex2, int& blockSize2) const noexcept
+    {
+        const int size = producer.size;
+        const int end = producer.index.load(std::memory_order_relaxed);
+        int freeSpace = getFreeSpace(end, producer.cachedOtherIndex, size);
+
+        if (freeSpace < numToWrite)
+        {
+            producer.cachedOtherIndex = consumer.index.load(std::memory_order_acquire);
+            freeSpace = getFreeSpace(end, producer.cachedOtherIndex, size);
+        }
+
+        getBlocks(end, std::min(numToWrite, freeSpace), size, startIndex1, blockSize1, startIndex2, blockSize2);
+    }
+
+    void finishedWrite(int numWritten) noexcept
+    {
+        assert(numWritten >= 0 && numWritten < producer.size);
+        producer.index.store(wrap(producer.index.load(std::memory_order_relaxed) + numWritten, producer.size), std::memory_order_release);
+    }
+
+    /** Consumer side, see juce::AbstractFifo::prepareToRead */
+    void prepareToRead(int numWanted, int& startIndex1, int& blockSize1, int& startIndex2, int& blockSize2) const noexcept
+    {
+        const int size = consumer.size;
+        const int start = consumer.index.load(std::memory_order_relaxed);
+        int numReady = getNumReady(start, consumer.cachedOtherIndex, size);
+
+        if (numReady < numWanted)
+        {
+            consumer.cachedOtherIndex = producer.index.load(std::memory_order_acquire);
+            numReady = getNumReady(start, consumer.cachedOtherIndex, size);
+        }
+
+        getBlocks(start, std::min(numWanted, numReady), size, startIndex1, blockSize1, startIndex2, blockSize2);
+    }
+
+    void finishedRead(int numRead) noexcept
+    {
+        assert(numRead >= 0 && numRead <= consumer.size);
+        consumer.index.store(wrap(consumer.index.load(std::memory_order_relaxed) + numRead, consumer.size), std::memory_order_release);
+    }
+
+private:
+    //Padding rather than alignas, which operator new doesn't honour before C++17
+    static constexpr int cacheLineSize = 64;
+
+    static int getNumReady(int start, int end, int size) noexcept
+    {
+        return end >= start ? (end - start) : (size - (start - end));
+    }
+
+    static int getFreeSpace(int end, int start, int size) noexcept { return size - getNumReady(start, end, size) - 1; }
+
+    static int wrap(int index, int size) noexcept { return index >= size ? index - size : index; }
+
+    static void getBlocks(int index, int num, int size, int& startIndex1, int& blockSize1, int& startIndex2, int& blockSize2) noexcept
+    {
+        startIndex1 = num <= 0 ? 0 : index;
+        startIndex2 = 0;
+        blockSize1 = num <= 0 ? 0 : std::min(size - index, num);
+        blockSize2 = num <= 0 ? 0 : num - blockSize1;
+    }
+
+    /** One side's index, its cached copy of the other side's and its own copy of the
+        capacity, a line apart from the other side's. Each side only reads its own size,
+        so the producer never touches the line the consumer's index is written to. */
+    struct IndexLine
+    {
+        char padding[cacheLineSize];
+        std::atomic<int> index { 0 };
+        int cachedOtherIndex = 0;
+        int size = 0;
+    };
+
+    mutable IndexLine producer, consumer;
+
+    //Keeps whatever is allocated after the fifo off the consumer's line
+    char trailingPadding[cacheLineSize];
+};
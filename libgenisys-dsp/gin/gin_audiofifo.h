@@ -9,11 +9,61 @@
 
 #pragma once
 
-#include "juce/juce_AbstractFifo.h"
+#include "genisys/genisys_spscfifo.h"
 #include "juce/juce_AudioSampleBuffer.h"
 #include "juce/juce_FloatVectorOperations.h"
 #include <assert.h>
 
+//==============================================================================
+/** A run of contiguous samples, standing in for std::span until we move past C++14 */
+template <typename SampleType>
+struct SampleSpan
+{
+    SampleType* data = nullptr;
+    int size = 0;
+
+    SampleType* begin() const noexcept { return data; }
+    SampleType* end() const noexcept { return data + size; }
+    bool empty() const noexcept { return size == 0; }
+};
+
+//==============================================================================
+/** Part of an AudioFifo's storage, as handed out by prepareToRead() or prepareToWrite().
+    Each channel's samples sit in up to two contiguous spans, the second one only
+    being used when the region wraps around the end of the storage.
+*/
+template <typename SampleType>
+class AudioFifoRegion
+{
+public:
+    AudioFifoRegion() = default;
+    AudioFifoRegion(SampleType* const* channelData, int numCh, int s1, int n1, int s2, int n2) noexcept
+        : channels(channelData), numChannels(numCh), start1(s1), size1(n1), start2(s2), size2(n2)
+    {
+    }
+
+    int getNumChannels() const noexcept { return numChannels; }
+    int getNumSamples() const noexcept { return size1 + size2; }
+
+    /** The span to use first, never empty unless the whole region is */
+    SampleSpan<SampleType> first(int channel) const noexcept
+    {
+        assert(channel >= 0 && channel < numChannels);
+        return { channels[channel] + start1, size1 };
+    }
+
+    /** Where the region continues after wrapping, empty if it doesn't wrap */
+    SampleSpan<SampleType> second(int channel) const noexcept
+    {
+        assert(channel >= 0 && channel < numChannels);
+        return { channels[channel] + start2, size2 };
+    }
+
+private:
+    SampleType* const* channels = nullptr;
+    int numChannels = 0, start1 = 0, size1 = 0, start2 = 0, size2 = 0;
+};
+
 //==============================================================================
 /** FIFO - stuff audio in one end and it pops out the other.
     Lock free for single producer / consumer 
@@ -152,7 +202,37 @@ public:
         return true;
     }
 
+    //==============================================================================
+    /** In place access, for producers and consumers that can work on the storage directly.
+        The regions stay valid until the matching finishedWrite() / finishedRead() call,
+        which may commit fewer samples than were prepared.
+    */
+    using ReadRegion = AudioFifoRegion<const float>;
+    using WriteRegion = AudioFifoRegion<float>;
+
+    WriteRegion prepareToWrite(int numSamples) noexcept
+    {
+        int start1, size1, start2, size2;
+        fifo.prepareToWrite(numSamples, start1, size1, start2, size2);
+
+        return { buffer.getArrayOfWritePointers(), buffer.getNumChannels(), start1, size1, start2, size2 };
+    }
+
+    void finishedWrite(int numWritten) noexcept { fifo.finishedWrite(numWritten); }
+
+    ReadRegion prepareToRead(int numSamples) const noexcept
+    {
+        int start1, size1, start2, size2;
+        fifo.prepareToRead(numSamples, start1, size1, start2, size2);
+
+        return { buffer.getArrayOfReadPointers(), buffer.getNumChannels(), start1, size1, start2, size2 };
+    }
+
+    void finishedRead(int numRead) noexcept { fifo.finishedRead(numRead); }
+
+    int getNumChannels() const noexcept { return buffer.getNumChannels(); }
+
 private:
-    juce::AbstractFifo fifo;
+    SpscFifo fifo;
     juce::AudioSampleBuffer buffer;
 };
@@ -11,17 +11,26 @@
 
 #include <assert.h>
 #include <memory>
+#include <vector>
 
+#include "genisys/genisys_polyphase.h"
 #include "gin_audiofifo.h"
 #include "juce/juce_AudioDataConverters.h"
 #include "juce/juce_AudioSampleBuffer.h"
 #include "libsamplerate/samplerate.h"
 
-/** ResamplingFifo - uses secret rabbit code
+/** ResamplingFifo - uses secret rabbit code, or a fixed ratio polyphase filter
+    when Engine::polyphase is selected and the rates allow it
  */
 class ResamplingFifo
 {
 public:
+    enum class Engine
+    {
+        sincFastest,
+        polyphase
+    };
+
     ResamplingFifo() = delete;
     ResamplingFifo(int blockSz, int numCh = 2, int maxSamples = 44100)
     {
@@ -37,29 +46,96 @@ public:
         numChannels = numCh;
         blockSize = blockSz;
 
+        if (impl->state != nullptr)
+            src_delete(impl->state);
+
         int error = 0;
         impl->state = src_new(SRC_SINC_FASTEST, numChannels, &error);
 
+        polyphase.setSize(numChannels, blockSize);
+
         outputFifo.setSize(numChannels, maxSamples);
+        outputPointers.assign(size_t(numChannels), nullptr);
 
         ilInputBuffer.setSize(1, blockSize * numChannels);
         ilOutputBuffer.setSize(1, 4 * blockSize * numChannels);
         outputBuffer.setSize(numChannels, 4 * blockSize);
+
+        zeroBuffer.setSize(numChannels, blockSize);
+        zeroBuffer.clear();
     }
 
+    /** Selects the resampler, takes effect on the next call to setResamplingRatio() */
+    void setEngine(Engine e) { engine = e; }
+    Engine getEngine() const noexcept { return engine; }
+
+    /** True when the polyphase filter is running rather than libsamplerate */
+    bool isUsingPolyphase() const noexcept { return usePolyphase; }
+
     void setResamplingRatio(double inputRate, double outputRate)
     {
         ratio = float(std::max(0.0, outputRate / inputRate));
+
+        //The polyphase filter only handles ratios between integer rates
+        usePolyphase = engine == Engine::polyphase && inputRate == std::floor(inputRate)
+                       && outputRate == std::floor(outputRate) && polyphase.setRates(int(inputRate), int(outputRate))
+                       && polyphase.getMaxOutputSamples(blockSize) <= outputBuffer.getNumSamples();
     }
 
-    void setRatio(float r) { ratio = r; }
+    void setRatio(float r)
+    {
+        ratio = r;
+        usePolyphase = false;
+    }
 
     void reset()
     {
         src_reset(impl->state);
         src_set_ratio(impl->state, ratio);
 
+        polyphase.reset();
+
         outputFifo.reset();
+        pushedSinceReset = false;
+    }
+
+    /** Ends the input, pushing what is still inside the filter out to the FIFO.
+        Does nothing if no audio was pushed since the last reset, call reset() before pushing more.
+    */
+    void flush()
+    {
+        if (!pushedSinceReset)
+            return;
+
+        if (usePolyphase)
+        {
+            //The filter delays by half its taps per phase at the input rate
+            for (int todo = polyphase.getNumTapsPerPhase() / 2 + 1; todo > 0; todo -= blockSize)
+                pushAudioBufferInt(juce::AudioSampleBuffer(
+                    zeroBuffer.getArrayOfWritePointers(), numChannels, std::min(todo, blockSize)));
+        }
+        else
+        {
+            //libsamplerate pads the end of input itself
+            SRC_DATA data;
+            data.data_in = ilInputBuffer.getReadPointer(0);
+            data.input_frames = 0;
+            data.data_out = ilOutputBuffer.getWritePointer(0);
+            data.output_frames = 4 * blockSize;
+            data.src_ratio = ratio;
+            data.end_of_input = 1;
+
+            do
+            {
+                data.output_frames_gen = 0;
+                src_process(impl->state, &data);
+
+                if (data.output_frames_gen > 0)
+                    writeInterleaved(ilOutputBuffer.getReadPointer(0), int(data.output_frames_gen));
+            } while (data.output_frames_gen > 0);
+        }
+
+        pushedSinceReset = false;
     }
 
     int samplesReady() { return outputFifo.getNumReady(); }
@@ -91,11 +167,46 @@ public:
 
     void popAudioBuffer(juce::AudioSampleBuffer& buffer) { outputFifo.read(buffer); }
 
+    /** Reads resampled audio in place rather than copying it out with popAudioBuffer().
+        Call finishedRead() with the number of samples consumed once done with the region.
+    */
+    AudioFifo::ReadRegion prepareToRead(int numSamples) const noexcept { return outputFifo.prepareToRead(numSamples); }
+    void finishedRead(int numRead) noexcept { outputFifo.finishedRead(numRead); }
+
 private:
     void pushAudioBufferInt(const juce::AudioSampleBuffer& buffer)
     {
         assert(buffer.getNumSamples() <= blockSize);
 
+        pushedSinceReset = true;
+
+        if (usePolyphase)
+        {
+            //Filter straight into the FIFO when the output won't wrap
+            const int maxOut = polyphase.getMaxOutputSamples(buffer.getNumSamples());
+            const auto region = outputFifo.prepareToWrite(maxOut);
+
+            if (numChannels > 0 && region.first(0).size >= maxOut)
+            {
+                for (int ch = 0; ch < numChannels; ++ch)
+                    outputPointers[size_t(ch)] = region.first(ch).data;
+
+                outputFifo.finishedWrite(
+                    polyphase.process(buffer.getArrayOfReadPointers(), buffer.getNumSamples(), outputPointers.data(), maxOut));
+                return;
+            }
+
+            const int numOut = polyphase.process(buffer.getArrayOfReadPointers(),
+                                                 buffer.getNumSamples(),
+                                                 outputBuffer.getArrayOfWritePointers(),
+                                                 outputBuffer.getNumSamples());
+
+            if (numOut > 0)
+                outputFifo.write(outputBuffer, numOut);
+
+            return;
+        }
+
         int todo = buffer.getNumSamples();
         int done = 0;
 
@@ -117,6 +228,12 @@ private:
 
             data.data_in = ilInputBuffer.getReadPointer(0) + done * numChannels;
 
+            //Mono output needs no deinterleaving, so let libsamplerate write into the FIFO
+            const auto region = outputFifo.prepareToWrite(int(data.output_frames));
+            const bool direct = numChannels == 1 && region.first(0).size >= data.output_frames;
+
+            data.data_out = direct ? region.first(0).data : ilOutputBuffer.getWritePointer(0);
+
             src_process(impl->state, &data);
 
             todo -= data.input_frames_used;
@@ -124,16 +241,41 @@ private:
 
             if (data.output_frames_gen > 0)
             {
-                juce::AudioDataConverters::deinterleaveSamples(ilOutputBuffer.getReadPointer(0),
-                                                               outputBuffer.getArrayOfWritePointers(),
-                                                               int(data.output_frames_gen),
-                                                               numChannels);
-
-                outputFifo.write(outputBuffer, int(data.output_frames_gen));
+                if (direct)
+                    outputFifo.finishedWrite(int(data.output_frames_gen));
+                else
+                    writeInterleaved(ilOutputBuffer.getReadPointer(0), int(data.output_frames_gen));
             }
         }
     }
 
+    /** Deinterleaves into the FIFO storage, dropping the block if it doesn't fit like AudioFifo::write() */
+    void writeInterleaved(const float* source, int numFrames)
+    {
+        const auto region = outputFifo.prepareToWrite(numFrames);
+        if (region.getNumSamples() < numFrames)
+            return;
+
+        for (int ch = 0; ch < numChannels; ++ch)
+            outputPointers[size_t(ch)] = region.first(ch).data;
+
+        juce::AudioDataConverters::deinterleaveSamples(
+            source, outputPointers.data(), region.first(0).size, numChannels);
+
+        if (!region.second(0).empty())
+        {
+            for (int ch = 0; ch < numChannels; ++ch)
+                outputPointers[size_t(ch)] = region.second(ch).data;
+
+            juce::AudioDataConverters::deinterleaveSamples(source + region.first(0).size * numChannels,
+                                                           outputPointers.data(),
+                                                           region.second(0).size,
+                                                           numChannels);
+        }
+
+        outputFifo.finishedWrite(numFrames);
+    }
+
     struct Impl
     {
         SRC_STATE* state = nullptr;
@@ -142,6 +284,10 @@ private:
 
     int numChannels = 0, blockSize = 0;
     float ratio = 1.0f;
+    Engine engine = Engine::sincFastest;
+    bool usePolyphase = false, pushedSinceReset = false;
+    PolyphaseResampler polyphase;
     AudioFifo outputFifo;
-    juce::AudioSampleBuffer ilInputBuffer, ilOutputBuffer, outputBuffer;
+    std::vector<float*> outputPointers;
+    juce::AudioSampleBuffer ilInputBuffer, ilOutputBuffer, outputBuffer, zeroBuffer;
 };
@@ -22,14 +22,412 @@
 
 #include "juce_AudioDataConverters.h"
 
+#include <cstring>
+
+//==============================================================================
+/*  Vectorised kernels for the packed little endian conversions.
+
+    Each one converts the longest prefix it can and returns how many samples it
+    did, the scalar loops below finish the rest. SSE2 is always there on x86-64
+    and AVX2 is picked at runtime; aarch64 uses NEON. Float to integer goes
+    through doubles, clamps and rounds to nearest even like roundToInt does, so
+    the results are bit for bit the same as the scalar loops. Define
+    JUCE_NO_SIMD_CONVERTERS to build without them.
+*/
+#if (defined(__x86_64__) || defined(_M_X64)) && !defined(JUCE_NO_SIMD_CONVERTERS)
+#define JUCE_SIMD_CONVERTERS_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define JUCE_TARGET_AVX2
+#else
+#define JUCE_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#elif (defined(__aarch64__) || defined(_M_ARM64)) && !defined(__AARCH64EB__) && !defined(JUCE_NO_SIMD_CONVERTERS)
+#define JUCE_SIMD_CONVERTERS_NEON 1
+#include <arm_neon.h>
+#endif
+
 namespace juce
 {
+namespace ConverterHelpers
+{
+// Input and output packed, and either apart or, for the narrowing float to integer
+// direction, starting at the same address so each store trails the loads
+static bool canVectorise(const void* source, int sourceBytes, const void* dest, int destBytes) noexcept
+{
+    auto s = static_cast<const char*>(source);
+    auto d = static_cast<const char*>(dest);
+    return s + sourceBytes <= d || d + destBytes <= s || (s == d && destBytes <= sourceBytes);
+}
+
+#if JUCE_SIMD_CONVERTERS_X86
+static bool hasAVX2() noexcept
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    static const bool avx2 = []
+    {
+        int info[4];
+        __cpuid(info, 0);
+        if (info[0] < 7)
+            return false;
+
+        __cpuid(info, 1);
+        const bool osAVX = ((info[2] >> 27) & 1) && ((info[2] >> 28) & 1) && ((_xgetbv(0) & 6) == 6);
+
+        __cpuidex(info, 7, 0);
+        return osAVX && ((info[1] >> 5) & 1) != 0;
+    }();
+#else
+    static const bool avx2 = []
+    {
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2") != 0;
+    }();
+#endif
+    return avx2;
+}
+
+//==============================================================================
+// SSE2
+static inline __m128i sse2FloatToInt(__m128 v, __m128d scale) noexcept
+{
+    const __m128d lo = _mm_min_pd(_mm_max_pd(_mm_mul_pd(_mm_cvtps_pd(v), scale), _mm_sub_pd(_mm_setzero_pd(), scale)), scale);
+    const __m128d hi = _mm_min_pd(_mm_max_pd(_mm_mul_pd(_mm_cvtps_pd(_mm_movehl_ps(v, v)), scale), _mm_sub_pd(_mm_setzero_pd(), scale)), scale);
+    return _mm_unpacklo_epi64(_mm_cvtpd_epi32(lo), _mm_cvtpd_epi32(hi));
+}
+
+static int sse2FloatToInt16(const float* source, void* dest, int numSamples) noexcept
+{
+    const __m128d scale = _mm_set1_pd((double)0x7fff);
+    auto d = static_cast<char*>(dest);
+    int i = 0;
+
+    for (; i + 8 <= numSamples; i += 8)
+    {
+        const __m128i a = sse2FloatToInt(_mm_loadu_ps(source + i), scale);
+        const __m128i b = sse2FloatToInt(_mm_loadu_ps(source + i + 4), scale);
+        _mm_storeu_si128((__m128i*)(d + 2 * i), _mm_packs_epi32(a, b));
+    }
+
+    return i;
+}
+
+static int sse2FloatToInt32(const float* source, void* dest, int numSamples) noexcept
+{
+    const __m128d scale = _mm_set1_pd((double)0x7fffffff);
+    auto d = static_cast<char*>(dest);
+    int i = 0;
+
+    for (; i + 4 <= numSamples; i += 4)
+        _mm_storeu_si128((__m128i*)(d + 4 * i), sse2FloatToInt(_mm_loadu_ps(source + i), scale));
+
+    return i;
+}
+
+static int sse2Int16ToFloat(const void* source, float* dest, int numSamples) noexcept
+{
+    const __m128 scale = _mm_set1_ps(1.0f / 0x7fff);
+    auto s = static_cast<const char*>(source);
+    int i = 0;
+
+    for (; i + 8 <= numSamples; i += 8)
+    {
+        const __m128i v = _mm_loadu_si128((const __m128i*)(s + 2 * i));
+        const __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16);
+        const __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16);
+        _mm_storeu_ps(dest + i, _mm_mul_ps(scale, _mm_cvtepi32_ps(lo)));
+        _mm_storeu_ps(dest + i + 4, _mm_mul_ps(scale, _mm_cvtepi32_ps(hi)));
+    }
+
+    return i;
+}
+
+static int sse2Int32ToFloat(const void* source, float* dest, int numSamples) noexcept
+{
+    const __m128 scale = _mm_set1_ps(1.0f / (float)0x7fffffff);
+    auto s = static_cast<const char*>(source);
+    int i = 0;
+
+    for (; i + 4 <= numSamples; i += 4)
+        _mm_storeu_ps(dest + i, _mm_mul_ps(scale, _mm_cvtepi32_ps(_mm_loadu_si128((const __m128i*)(s + 4 * i)))));
+
+    return i;
+}
+
+//==============================================================================
+// AVX2
+JUCE_TARGET_AVX2 static inline __m128i avx2FloatToInt(__m128 v, __m256d scale) noexcept
+{
+    const __m256d x = _mm256_mul_pd(_mm256_cvtps_pd(v), scale);
+    return _mm256_cvtpd_epi32(_mm256_min_pd(_mm256_max_pd(x, _mm256_sub_pd(_mm256_setzero_pd(), scale)), scale));
+}
+
+JUCE_TARGET_AVX2 static int avx2FloatToInt16(const float* source, void* dest, int numSamples) noexcept
+{
+    const __m256d scale = _mm256_set1_pd((double)0x7fff);
+    auto d = static_cast<char*>(dest);
+    int i = 0;
+
+    for (; i + 16 <= numSamples; i += 16)
+    {
+        const __m128i a = avx2FloatToInt(_mm_loadu_ps(source + i), scale);
+        const __m128i b = avx2FloatToInt(_mm_loadu_ps(source + i + 4), scale);
+        const __m128i c = avx2FloatToInt(_mm_loadu_ps(source + i + 8), scale);
+        const __m128i e = avx2FloatToInt(_mm_loadu_ps(source + i + 12), scale);
+        _mm_storeu_si128((__m128i*)(d + 2 * i), _mm_packs_epi32(a, b));
+        _mm_storeu_si128((__m128i*)(d + 2 * i + 16), _mm_packs_epi32(c, e));
+    }
+
+    return i;
+}
+
+JUCE_TARGET_AVX2 static int avx2FloatToInt24(const float* source, void* dest, int numSamples) noexcept
+{
+    const __m256d scale = _mm256_set1_pd((double)0x7fffff);
+    const __m128i pack = _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+    auto d = static_cast<char*>(dest);
+    int i = 0;
+
+    // Twelve bytes out per four samples, written as eight and four so nothing past them is touched
+    for (; i + 4 <= numSamples; i += 4)
+    {
+        const __m128i v = _mm_shuffle_epi8(avx2FloatToInt(_mm_loadu_ps(source + i), scale), pack);
+        const int last = _mm_cvtsi128_si32(_mm_srli_si128(v, 8));
+        _mm_storel_epi64((__m128i*)(d + 3 * i), v);
+        memcpy(d + 3 * i + 8, &last, 4);
+    }
+
+    return i;
+}
+
+JUCE_TARGET_AVX2 static int avx2FloatToInt32(const float* source, void* dest, int numSamples) noexcept
+{
+    const __m256d scale = _mm256_set1_pd((double)0x7fffffff);
+    auto d = static_cast<char*>(dest);
+    int i = 0;
+
+    for (; i + 8 <= numSamples; i += 8)
+    {
+        _mm_storeu_si128((__m128i*)(d + 4 * i), avx2FloatToInt(_mm_loadu_ps(source + i), scale));
+        _mm_storeu_si128((__m128i*)(d + 4 * i + 16), avx2FloatToInt(_mm_loadu_ps(source + i + 4), scale));
+    }
+
+    return i;
+}
+
+JUCE_TARGET_AVX2 static int avx2Int16ToFloat(const void* source, float* dest, int numSamples) noexcept
+{
+    const __m256 scale = _mm256_set1_ps(1.0f / 0x7fff);
+    auto s = static_cast<const char*>(source);
+    int i = 0;
+
+    for (; i + 16 <= numSamples; i += 16)
+    {
+        const __m256i a = _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i*)(s + 2 * i)));
+        const __m256i b = _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i*)(s + 2 * i + 16)));
+        _mm256_storeu_ps(dest + i, _mm256_mul_ps(scale, _mm256_cvtepi32_ps(a)));
+        _mm256_storeu_ps(dest + i + 8, _mm256_mul_ps(scale, _mm256_cvtepi32_ps(b)));
+    }
+
+    return i;
+}
+
+JUCE_TARGET_AVX2 static int avx2Int24ToFloat(const void* source, float* dest, int numSamples) noexcept
+{
+    const __m256 scale = _mm256_set1_ps(1.0f / 0x7fffff);
+    // Each sample's three bytes go to the top of a lane, the shift brings the sign down with them
+    const __m128i unpack = _mm_setr_epi8(-1, 0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11);
+    auto s = static_cast<const char*>(source);
+    int i = 0;
+
+    // The sixteen byte loads run four bytes past the eight samples used, so stop short of the end
+    for (; i + 10 <= numSamples; i += 8)
+    {
+        const __m128i lo = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(s + 3 * i)), unpack);
+        const __m128i hi = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(s + 3 * i + 12)), unpack);
+        const __m256i v = _mm256_srai_epi32(_mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1), 8);
+        _mm256_storeu_ps(dest + i, _mm256_mul_ps(scale, _mm256_cvtepi32_ps(v)));
+    }
+
+    return i;
+}
+
+JUCE_TARGET_AVX2 static int avx2Int32ToFloat(const void* source, float* dest, int numSamples) noexcept
+{
+    const __m256 scale = _mm256_set1_ps(1.0f / (float)0x7fffffff);
+    auto s = static_cast<const char*>(source);
+    int i = 0;
+
+    for (; i + 8 <= numSamples; i += 8)
+        _mm256_storeu_ps(dest + i, _mm256_mul_ps(scale, _mm256_cvtepi32_ps(_mm256_loadu_si256((const __m256i*)(s + 4 * i)))));
+
+    return i;
+}
+
+//==============================================================================
+static int floatToInt16(const float* source, void* dest, int numSamples) noexcept
+{
+    return hasAVX2() ? avx2FloatToInt16(source, dest, numSamples) : sse2FloatToInt16(source, dest, numSamples);
+}
+
+static int floatToInt24(const float* source, void* dest, int numSamples) noexcept
+{
+    // Packing the bytes needs pshufb, which SSE2 doesn't have
+    return hasAVX2() ? avx2FloatToInt24(source, dest, numSamples) : 0;
+}
+
+static int floatToInt32(const float* source, void* dest, int numSamples) noexcept
+{
+    return hasAVX2() ? avx2FloatToInt32(source, dest, numSamples) : sse2FloatToInt32(source, dest, numSamples);
+}
+
+static int int16ToFloat(const void* source, float* dest, int numSamples) noexcept
+{
+    return hasAVX2() ? avx2Int16ToFloat(source, dest, numSamples) : sse2Int16ToFloat(source, dest, numSamples);
+}
+
+static int int24ToFloat(const void* source, float* dest, int numSamples) noexcept
+{
+    return hasAVX2() ? avx2Int24ToFloat(source, dest, numSamples) : 0;
+}
+
+static int int32ToFloat(const void* source, float* dest, int numSamples) noexcept
+{
+    return hasAVX2() ? avx2Int32ToFloat(source, dest, numSamples) : sse2Int32ToFloat(source, dest, numSamples);
+}
+
+#elif JUCE_SIMD_CONVERTERS_NEON
+static inline int32x4_t neonFloatToInt(float32x4_t v, double maxVal) noexcept
+{
+    const float64x2_t scale = vdupq_n_f64(maxVal);
+    const float64x2_t lowest = vdupq_n_f64(-maxVal);
+    const float64x2_t lo = vminq_f64(vmaxq_f64(vmulq_f64(vcvt_f64_f32(vget_low_f32(v)), scale), lowest), scale);
+    const float64x2_t hi = vminq_f64(vmaxq_f64(vmulq_f64(vcvt_high_f64_f32(v), scale), lowest), scale);
+    return vcombine_s32(vmovn_s64(vcvtnq_s64_f64(lo)), vmovn_s64(vcvtnq_s64_f64(hi)));
+}
+
+static int floatToInt16(const float* source, void* dest, int numSamples) noexcept
+{
+    auto d = static_cast<int16_t*>(dest);
+    int i = 0;
+
+    for (; i + 8 <= numSamples; i += 8)
+    {
+        const int32x4_t a = neonFloatToInt(vld1q_f32(source + i), (double)0x7fff);
+        const int32x4_t b = neonFloatToInt(vld1q_f32(source + i + 4), (double)0x7fff);
+        vst1q_u8(reinterpret_cast<uint8_t*>(d + i), vreinterpretq_u8_s16(vcombine_s16(vqmovn_s32(a), vqmovn_s32(b))));
+    }
+
+    return i;
+}
+
+static int floatToInt24(const float* source, void* dest, int numSamples) noexcept
+{
+    auto d = static_cast<uint8_t*>(dest);
+    int i = 0;
+
+    for (; i + 8 <= numSamples; i += 8)
+    {
+        const uint32x4_t a = vreinterpretq_u32_s32(neonFloatToInt(vld1q_f32(source + i), (double)0x7fffff));
+        const uint32x4_t b = vreinterpretq_u32_s32(neonFloatToInt(vld1q_f32(source + i + 4), (double)0x7fffff));
+        const uint16x8_t low = vcombine_u16(vmovn_u32(a), vmovn_u32(b));
+
+        uint8x8x3_t bytes;
+        bytes.val[0] = vmovn_u16(low);
+        bytes.val[1] = vshrn_n_u16(low, 8);
+        bytes.val[2] = vmovn_u16(vcombine_u16(vshrn_n_u32(a, 16), vshrn_n_u32(b, 16)));
+        vst3_u8(d + 3 * i, bytes);
+    }
+
+    return i;
+}
+
+static int floatToInt32(const float* source, void* dest, int numSamples) noexcept
+{
+    auto d = static_cast<int32_t*>(dest);
+    int i = 0;
+
+    for (; i + 4 <= numSamples; i += 4)
+        vst1q_u8(reinterpret_cast<uint8_t*>(d + i), vreinterpretq_u8_s32(neonFloatToInt(vld1q_f32(source + i), (double)0x7fffffff)));
+
+    return i;
+}
+
+static int int16ToFloat(const void* source, float* dest, int numSamples) noexcept
+{
+    const float scale = 1.0f / 0x7fff;
+    auto s = static_cast<const int16_t*>(source);
+    int i = 0;
+
+    for (; i + 8 <= numSamples; i += 8)
+    {
+        const int16x8_t v = vreinterpretq_s16_u8(vld1q_u8(reinterpret_cast<const uint8_t*>(s + i)));
+        vst1q_f32(dest + i, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(v))), scale));
+        vst1q_f32(dest + i + 4, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(v))), scale));
+    }
+
+    return i;
+}
+
+static int int24ToFloat(const void* source, float* dest, int numSamples) noexcept
+{
+    const float scale = 1.0f / 0x7fffff;
+    auto s = static_cast<const uint8_t*>(source);
+    int i = 0;
+
+    for (; i + 8 <= numSamples; i += 8)
+    {
+        const uint8x8x3_t bytes = vld3_u8(s + 3 * i);
+        const uint16x8_t low = vorrq_u16(vmovl_u8(bytes.val[0]), vshll_n_u8(bytes.val[1], 8));
+        const int16x8_t high = vmovl_s8(vreinterpret_s8_u8(bytes.val[2]));
+
+        const int32x4_t a = vorrq_s32(vshll_n_s16(vget_low_s16(high), 16), vreinterpretq_s32_u32(vmovl_u16(vget_low_u16(low))));
+        const int32x4_t b = vorrq_s32(vshll_n_s16(vget_high_s16(high), 16), vreinterpretq_s32_u32(vmovl_u16(vget_high_u16(low))));
+        vst1q_f32(dest + i, vmulq_n_f32(vcvtq_f32_s32(a), scale));
+        vst1q_f32(dest + i + 4, vmulq_n_f32(vcvtq_f32_s32(b), scale));
+    }
+
+    return i;
+}
+
+static int int32ToFloat(const void* source, float* dest, int numSamples) noexcept
+{
+    const float scale = 1.0f / (float)0x7fffffff;
+    auto s = static_cast<const int32_t*>(source);
+    int i = 0;
+
+    for (; i + 4 <= numSamples; i += 4)
+        vst1q_f32(dest + i, vmulq_n_f32(vcvtq_f32_s32(vreinterpretq_s32_u8(vld1q_u8(reinterpret_cast<const uint8_t*>(s + i)))), scale));
+
+    return i;
+}
+
+#else
+static int floatToInt16(const float*, void*, int) noexcept { return 0; }
+static int floatToInt24(const float*, void*, int) noexcept { return 0; }
+static int floatToInt32(const float*, void*, int) noexcept { return 0; }
+static int int16ToFloat(const void*, float*, int) noexcept { return 0; }
+static int int24ToFloat(const void*, float*, int) noexcept { return 0; }
+static int int32ToFloat(const void*, float*, int) noexcept { return 0; }
+#endif
+} // namespace ConverterHelpers
+
+
 
 void AudioDataConverters::convertFloatToInt16LE(const float* source, void* dest, int numSamples, int destBytesPerSample)
 {
     auto maxVal = (double)0x7fff;
     auto intData = static_cast<char*>(dest);
 
+    if (destBytesPerSample == 2 && ConverterHelpers::canVectorise(source, 4 * numSamples, dest, 2 * numSamples))
+    {
+        const int numDone = ConverterHelpers::floatToInt16(source, dest, numSamples);
+        source += numDone;
+        intData += 2 * numDone;
+        numSamples -= numDone;
+    }
+
     if (dest != (void*)source || destBytesPerSample <= 4)
     {
         for (int i = 0; i < numSamples; ++i)
@@ -84,6 +482,14 @@ void AudioDataConverters::convertFloatToInt24LE(const float* source, void* dest,
     auto maxVal = (double)0x7fffff;
     auto intData = static_cast<char*>(dest);
 
+    if (destBytesPerSample == 3 && ConverterHelpers::canVectorise(source, 4 * numSamples, dest, 3 * numSamples))
+    {
+        const int numDone = ConverterHelpers::floatToInt24(source, dest, numSamples);
+        source += numDone;
+        intData += 3 * numDone;
+        numSamples -= numDone;
+    }
+
     if (dest != (void*)source || destBytesPerSample <= 4)
     {
         for (int i = 0; i < numSamples; ++i)
@@ -134,6 +540,14 @@ void AudioDataConverters::convertFloatToInt32LE(const float* source, void* dest,
     auto maxVal = (double)0x7fffffff;
     auto intData = static_cast<char*>(dest);
 
+    if (destBytesPerSample == 4 && ConverterHelpers::canVectorise(source, 4 * numSamples, dest, 4 * numSamples))
+    {
+        const int numDone = ConverterHelpers::floatToInt32(source, dest, numSamples);
+        source += numDone;
+        intData += 4 * numDone;
+        numSamples -= numDone;
+    }
+
     if (dest != (void*)source || destBytesPerSample <= 4)
     {
         for (int i = 0; i < numSamples; ++i)
@@ -231,6 +645,14 @@ void AudioDataConverters::convertInt16LEToFloat(const void* source, float* dest,
     const float scale = 1.0f / 0x7fff;
     auto intData = static_cast<const char*>(source);
 
+    if (srcBytesPerSample == 2 && ConverterHelpers::canVectorise(source, 2 * numSamples, dest, 4 * numSamples))
+    {
+        const int numDone = ConverterHelpers::int16ToFloat(source, dest, numSamples);
+        intData += 2 * numDone;
+        dest += numDone;
+        numSamples -= numDone;
+    }
+
     if (source != (void*)dest || srcBytesPerSample >= 4)
     {
         for (int i = 0; i < numSamples; ++i)
@@ -281,11 +703,19 @@ void AudioDataConverters::convertInt24LEToFloat(const void* source, float* dest,
     const float scale = 1.0f / 0x7fffff;
     auto intData = static_cast<const char*>(source);
 
+    if (srcBytesPerSample == 3 && ConverterHelpers::canVectorise(source, 3 * numSamples, dest, 4 * numSamples))
+    {
+        const int numDone = ConverterHelpers::int24ToFloat(source, dest, numSamples);
+        intData += 3 * numDone;
+        dest += numDone;
+        numSamples -= numDone;
+    }
+
     if (source != (void*)dest || srcBytesPerSample >= 4)
     {
         for (int i = 0; i < numSamples; ++i)
         {
-            dest[i] = scale * (short)ByteOrder::littleEndian24Bit(intData);
+            dest[i] = scale * (float)ByteOrder::littleEndian24Bit(intData);
             intData += srcBytesPerSample;
         }
     }
@@ -296,7 +726,7 @@ void AudioDataConverters::convertInt24LEToFloat(const void* source, float* dest,
         for (int i = numSamples; --i >= 0;)
         {
             intData -= srcBytesPerSample;
-            dest[i] = scale * (short)ByteOrder::littleEndian24Bit(intData);
+            dest[i] = scale * (float)ByteOrder::littleEndian24Bit(intData);
         }
     }
 }
@@ -310,7 +740,7 @@ void AudioDataConverters::convertInt24BEToFloat(const void* source, float* dest,
     {
         for (int i = 0; i < numSamples; ++i)
         {
-            dest[i] = scale * (short)ByteOrder::bigEndian24Bit(intData);
+            dest[i] = scale * (float)ByteOrder::bigEndian24Bit(intData);
             intData += srcBytesPerSample;
         }
     }
@@ -321,7 +751,7 @@ void AudioDataConverters::convertInt24BEToFloat(const void* source, float* dest,
         for (int i = numSamples; --i >= 0;)
         {
             intData -= srcBytesPerSample;
-            dest[i] = scale * (short)ByteOrder::bigEndian24Bit(intData);
+            dest[i] = scale * (float)ByteOrder::bigEndian24Bit(intData);
         }
     }
 }
@@ -331,11 +761,19 @@ void AudioDataConverters::convertInt32LEToFloat(const void* source, float* dest,
     const float scale = 1.0f / (float)0x7fffffff;
     auto intData = static_cast<const char*>(source);
 
+    if (srcBytesPerSample == 4 && ConverterHelpers::canVectorise(source, 4 * numSamples, dest, 4 * numSamples))
+    {
+        const int numDone = ConverterHelpers::int32ToFloat(source, dest, numSamples);
+        intData += 4 * numDone;
+        dest += numDone;
+        numSamples -= numDone;
+    }
+
     if (source != (void*)dest || srcBytesPerSample >= 4)
     {
         for (int i = 0; i < numSamples; ++i)
         {
-            dest[i] = scale * (float)ByteOrder::swapIfBigEndian(*unalignedPointerCast<const uint32*>(intData));
+            dest[i] = scale * (float)(int)ByteOrder::swapIfBigEndian(*unalignedPointerCast<const uint32*>(intData));
             intData += srcBytesPerSample;
         }
     }
@@ -346,7 +784,7 @@ void AudioDataConverters::convertInt32LEToFloat(const void* source, float* dest,
         for (int i = numSamples; --i >= 0;)
         {
             intData -= srcBytesPerSample;
-            dest[i] = scale * (float)ByteOrder::swapIfBigEndian(*unalignedPointerCast<const uint32*>(intData));
+            dest[i] = scale * (float)(int)ByteOrder::swapIfBigEndian(*unalignedPointerCast<const uint32*>(intData));
         }
     }
 }
@@ -360,7 +798,7 @@ void AudioDataConverters::convertInt32BEToFloat(const void* source, float* dest,
     {
         for (int i = 0; i < numSamples; ++i)
         {
-            dest[i] = scale * (float)ByteOrder::swapIfLittleEndian(*unalignedPointerCast<const uint32*>(intData));
+            dest[i] = scale * (float)(int)ByteOrder::swapIfLittleEndian(*unalignedPointerCast<const uint32*>(intData));
             intData += srcBytesPerSample;
         }
     }
@@ -371,7 +809,7 @@ void AudioDataConverters::convertInt32BEToFloat(const void* source, float* dest,
         for (int i = numSamples; --i >= 0;)
         {
             intData -= srcBytesPerSample;
-            dest[i] = scale * (float)ByteOrder::swapIfLittleEndian(*unalignedPointerCast<const uint32*>(intData));
+            dest[i] = scale * (float)(int)ByteOrder::swapIfLittleEndian(*unalignedPointerCast<const uint32*>(intData));
         }
     }
 }
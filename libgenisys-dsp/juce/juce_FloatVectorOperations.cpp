@@ -23,6 +23,12 @@
 #include "juce_FloatVectorOperations.h"
 #include "juce_Memory.h"
 
+#include <type_traits>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
 namespace Power
 {
 // Template specialization of exponent methods using
@@ -170,7 +176,7 @@ namespace FloatVectorHelpers
 #define JUCE_INCREMENT_DEST dest += (16 / sizeof(*dest));
 
 #if JUCE_USE_SSE_INTRINSICS
-    static bool isAligned(const void* p) noexcept { return (((pointer_sized_int)p) & 15) == 0; }
+    static bool isAligned(const void* p) noexcept { return (((uintptr_t)p) & 15) == 0; }
 
     struct BasicOps32
     {
@@ -757,6 +763,345 @@ namespace FloatVectorHelpers
             return Range<Type>::findMinAndMax(src, num);
         }
     };
+#endif
+
+    //==============================================================================
+    /*  Wider versions of the hot ops, picked once at startup from cpuid.
+
+        The kernels are defined once per instruction set by JUCE_DEFINE_WIDE_KERNELS
+        under that set's target pragma, so nothing built for AVX-512 can leak into
+        the AVX2 path. They do the same operations in the same order as the SSE and
+        scalar loops, and contraction into fused multiply-adds is switched off for
+        them, so every path gives the same results. Define JUCE_NO_AVX_DISPATCH to
+        stay on SSE, or JUCE_NO_AVX512 to stop at AVX2.
+    */
+#if JUCE_USE_SSE_INTRINSICS && (defined(__x86_64__) || defined(_M_X64)) && !defined(JUCE_NO_AVX_DISPATCH)
+
+    enum SimdLevel
+    {
+        sse = 0,
+        avx2,
+        avx512
+    };
+
+    static int detectSimdLevel() noexcept
+    {
+#if defined(_MSC_VER) && !defined(__clang__)
+        int info[4];
+        __cpuid(info, 0);
+        if (info[0] < 7)
+            return sse;
+
+        __cpuid(info, 1);
+        if (!((info[2] >> 27) & 1) || !((info[2] >> 28) & 1))
+            return sse;
+
+        const auto xcr0 = _xgetbv(0);
+        __cpuidex(info, 7, 0);
+
+#if !defined(JUCE_NO_AVX512)
+        if (((info[1] >> 16) & 1) && (xcr0 & 0xe6) == 0xe6)
+            return avx512;
+#endif
+        return ((info[1] >> 5) & 1) && (xcr0 & 6) == 6 ? avx2 : sse;
+#else
+        __builtin_cpu_init();
+
+#if !defined(JUCE_NO_AVX512)
+        if (__builtin_cpu_supports("avx512f"))
+            return avx512;
+#endif
+        return __builtin_cpu_supports("avx2") ? avx2 : sse;
+#endif
+    }
+
+    // Set while static objects are constructed; anything running before that stays on SSE
+    static const int simdLevel = detectSimdLevel();
+
+#define JUCE_DEFINE_WIDE_KERNELS                                                                       \
+    template <typename T>                                                                              \
+    using OpsFor = typename std::conditional<sizeof(T) == 4, Ops32, Ops64>::type;                      \
+                                                                                                       \
+    template <typename T>                                                                              \
+    static void add(T* dest, const T* src1, const T* src2, int num) noexcept                           \
+    {                                                                                                  \
+        using Ops = OpsFor<T>;                                                                         \
+        int i = 0;                                                                                     \
+        for (; i + Ops::numParallel <= num; i += Ops::numParallel)                                     \
+            Ops::storeU(dest + i, Ops::add(Ops::loadU(src1 + i), Ops::loadU(src2 + i)));               \
+        for (; i < num; ++i)                                                                           \
+            dest[i] = src1[i] + src2[i];                                                               \
+    }                                                                                                  \
+                                                                                                       \
+    template <typename T>                                                                              \
+    static void add(T* dest, const T* src, T amount, int num) noexcept                                 \
+    {                                                                                                  \
+        using Ops = OpsFor<T>;                                                                         \
+        const auto am = Ops::load1(amount);                                                            \
+        int i = 0;                                                                                     \
+        for (; i + Ops::numParallel <= num; i += Ops::numParallel)                                     \
+            Ops::storeU(dest + i, Ops::add(am, Ops::loadU(src + i)));                                  \
+        for (; i < num; ++i)                                                                           \
+            dest[i] = src[i] + amount;                                                                 \
+    }                                                                                                  \
+                                                                                                       \
+    template <typename T>                                                                              \
+    static void multiply(T* dest, const T* src1, const T* src2, int num) noexcept                      \
+    {                                                                                                  \
+        using Ops = OpsFor<T>;                                                                         \
+        int i = 0;                                                                                     \
+        for (; i + Ops::numParallel <= num; i += Ops::numParallel)                                     \
+            Ops::storeU(dest + i, Ops::mul(Ops::loadU(src1 + i), Ops::loadU(src2 + i)));               \
+        for (; i < num; ++i)                                                                           \
+            dest[i] = src1[i] * src2[i];                                                               \
+    }                                                                                                  \
+                                                                                                       \
+    template <typename T>                                                                              \
+    static void multiply(T* dest, const T* src, T multiplier, int num) noexcept                        \
+    {                                                                                                  \
+        using Ops = OpsFor<T>;                                                                         \
+        const auto mult = Ops::load1(multiplier);                                                      \
+        int i = 0;                                                                                     \
+        for (; i + Ops::numParallel <= num; i += Ops::numParallel)                                     \
+            Ops::storeU(dest + i, Ops::mul(mult, Ops::loadU(src + i)));                                \
+        for (; i < num; ++i)                                                                           \
+            dest[i] = src[i] * multiplier;                                                             \
+    }                                                                                                  \
+                                                                                                       \
+    template <typename T>                                                                              \
+    static void addWithMultiply(T* dest, const T* src1, const T* src2, int num) noexcept               \
+    {                                                                                                  \
+        using Ops = OpsFor<T>;                                                                         \
+        int i = 0;                                                                                     \
+        for (; i + Ops::numParallel <= num; i += Ops::numParallel)                                     \
+            Ops::storeU(dest + i,                                                                      \
+                        Ops::add(Ops::loadU(dest + i), Ops::mul(Ops::loadU(src1 + i), Ops::loadU(src2 + i)))); \
+        for (; i < num; ++i)                                                                           \
+            dest[i] += src1[i] * src2[i];                                                              \
+    }                                                                                                  \
+                                                                                                       \
+    template <typename T>                                                                              \
+    static void addWithMultiply(T* dest, const T* src, T multiplier, int num) noexcept                 \
+    {                                                                                                  \
+        using Ops = OpsFor<T>;                                                                         \
+        const auto mult = Ops::load1(multiplier);                                                      \
+        int i = 0;                                                                                     \
+        for (; i + Ops::numParallel <= num; i += Ops::numParallel)                                     \
+            Ops::storeU(dest + i, Ops::add(Ops::loadU(dest + i), Ops::mul(mult, Ops::loadU(src + i)))); \
+        for (; i < num; ++i)                                                                           \
+            dest[i] += src[i] * multiplier;                                                            \
+    }                                                                                                  \
+                                                                                                       \
+    template <typename T>                                                                              \
+    static void clip(T* dest, const T* src, T low, T high, int num) noexcept                           \
+    {                                                                                                  \
+        using Ops = OpsFor<T>;                                                                         \
+        const auto lo = Ops::load1(low), hi = Ops::load1(high);                                        \
+        int i = 0;                                                                                     \
+        for (; i + Ops::numParallel <= num; i += Ops::numParallel)                                     \
+            Ops::storeU(dest + i, Ops::max(Ops::min(Ops::loadU(src + i), hi), lo));                    \
+        for (; i < num; ++i)                                                                           \
+            dest[i] = jmax(jmin(src[i], high), low);                                                   \
+    }                                                                                                  \
+                                                                                                       \
+    template <typename T>                                                                              \
+    static void abs(T* dest, const T* src, int num) noexcept                                           \
+    {                                                                                                  \
+        using Ops = OpsFor<T>;                                                                         \
+        int i = 0;                                                                                     \
+        for (; i + Ops::numParallel <= num; i += Ops::numParallel)                                     \
+            Ops::storeU(dest + i, Ops::abs(Ops::loadU(src + i)));                                      \
+        for (; i < num; ++i)                                                                           \
+            dest[i] = std::abs(src[i]);                                                                \
+    }                                                                                                  \
+                                                                                                       \
+    template <typename T>                                                                              \
+    static Range<T> findMinAndMax(const T* src, int num) noexcept                                      \
+    {                                                                                                  \
+        using Ops = OpsFor<T>;                                                                         \
+        if (num < 2 * Ops::numParallel)                                                                \
+            return Range<T>::findMinAndMax(src, num);                                                  \
+                                                                                                       \
+        auto mn = Ops::loadU(src), mx = mn;                                                            \
+        int i = Ops::numParallel;                                                                      \
+        for (; i + Ops::numParallel <= num; i += Ops::numParallel)                                     \
+        {                                                                                              \
+            const auto v = Ops::loadU(src + i);                                                        \
+            mn = Ops::min(mn, v);                                                                      \
+            mx = Ops::max(mx, v);                                                                      \
+        }                                                                                              \
+                                                                                                       \
+        Range<T> result(Ops::min(mn), Ops::max(mx));                                                   \
+        for (; i < num; ++i)                                                                           \
+            result = result.getUnionWith(src[i]);                                                      \
+        return result;                                                                                 \
+    }
+
+#if defined(__clang__)
+#pragma clang attribute push(__attribute__((target("avx2"))), apply_to = function)
+#pragma float_control(push)
+#pragma clang fp contract(off)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("avx2")
+#pragma GCC optimize("fp-contract=off")
+#endif
+
+    namespace AVX2
+    {
+        struct Ops32
+        {
+            using ParallelType = __m256;
+            enum
+            {
+                numParallel = 8
+            };
+
+            static forcedinline ParallelType load1(float v) noexcept { return _mm256_set1_ps(v); }
+            static forcedinline ParallelType loadU(const float* v) noexcept { return _mm256_loadu_ps(v); }
+            static forcedinline void storeU(float* dest, ParallelType a) noexcept { _mm256_storeu_ps(dest, a); }
+            static forcedinline ParallelType add(ParallelType a, ParallelType b) noexcept { return _mm256_add_ps(a, b); }
+            static forcedinline ParallelType mul(ParallelType a, ParallelType b) noexcept { return _mm256_mul_ps(a, b); }
+            static forcedinline ParallelType max(ParallelType a, ParallelType b) noexcept { return _mm256_max_ps(a, b); }
+            static forcedinline ParallelType min(ParallelType a, ParallelType b) noexcept { return _mm256_min_ps(a, b); }
+            static forcedinline ParallelType abs(ParallelType a) noexcept
+            {
+                return _mm256_and_ps(a, _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff)));
+            }
+
+            static forcedinline float max(ParallelType a) noexcept
+            {
+                const __m128 m = _mm_max_ps(_mm256_castps256_ps128(a), _mm256_extractf128_ps(a, 1));
+                return BasicOps32::max(m);
+            }
+
+            static forcedinline float min(ParallelType a) noexcept
+            {
+                const __m128 m = _mm_min_ps(_mm256_castps256_ps128(a), _mm256_extractf128_ps(a, 1));
+                return BasicOps32::min(m);
+            }
+        };
+
+        struct Ops64
+        {
+            using ParallelType = __m256d;
+            enum
+            {
+                numParallel = 4
+            };
+
+            static forcedinline ParallelType load1(double v) noexcept { return _mm256_set1_pd(v); }
+            static forcedinline ParallelType loadU(const double* v) noexcept { return _mm256_loadu_pd(v); }
+            static forcedinline void storeU(double* dest, ParallelType a) noexcept { _mm256_storeu_pd(dest, a); }
+            static forcedinline ParallelType add(ParallelType a, ParallelType b) noexcept { return _mm256_add_pd(a, b); }
+            static forcedinline ParallelType mul(ParallelType a, ParallelType b) noexcept { return _mm256_mul_pd(a, b); }
+            static forcedinline ParallelType max(ParallelType a, ParallelType b) noexcept { return _mm256_max_pd(a, b); }
+            static forcedinline ParallelType min(ParallelType a, ParallelType b) noexcept { return _mm256_min_pd(a, b); }
+            static forcedinline ParallelType abs(ParallelType a) noexcept
+            {
+                return _mm256_and_pd(a, _mm256_castsi256_pd(_mm256_set1_epi64x(0x7fffffffffffffffLL)));
+            }
+
+            static forcedinline double max(ParallelType a) noexcept
+            {
+                return BasicOps64::max(_mm_max_pd(_mm256_castpd256_pd128(a), _mm256_extractf128_pd(a, 1)));
+            }
+
+            static forcedinline double min(ParallelType a) noexcept
+            {
+                return BasicOps64::min(_mm_min_pd(_mm256_castpd256_pd128(a), _mm256_extractf128_pd(a, 1)));
+            }
+        };
+
+        JUCE_DEFINE_WIDE_KERNELS
+    } // namespace AVX2
+
+#if defined(__clang__)
+#pragma float_control(pop)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
+
+#if !defined(JUCE_NO_AVX512)
+#if defined(__clang__)
+#pragma clang attribute push(__attribute__((target("avx512f"))), apply_to = function)
+#pragma float_control(push)
+#pragma clang fp contract(off)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("avx512f")
+#pragma GCC optimize("fp-contract=off")
+#endif
+
+    namespace AVX512
+    {
+        struct Ops32
+        {
+            using ParallelType = __m512;
+            enum
+            {
+                numParallel = 16
+            };
+
+            static forcedinline ParallelType load1(float v) noexcept { return _mm512_set1_ps(v); }
+            static forcedinline ParallelType loadU(const float* v) noexcept { return _mm512_loadu_ps(v); }
+            static forcedinline void storeU(float* dest, ParallelType a) noexcept { _mm512_storeu_ps(dest, a); }
+            static forcedinline ParallelType add(ParallelType a, ParallelType b) noexcept { return _mm512_add_ps(a, b); }
+            static forcedinline ParallelType mul(ParallelType a, ParallelType b) noexcept { return _mm512_mul_ps(a, b); }
+            static forcedinline ParallelType max(ParallelType a, ParallelType b) noexcept { return _mm512_max_ps(a, b); }
+            static forcedinline ParallelType min(ParallelType a, ParallelType b) noexcept { return _mm512_min_ps(a, b); }
+            static forcedinline ParallelType abs(ParallelType a) noexcept { return _mm512_abs_ps(a); }
+            static forcedinline float max(ParallelType a) noexcept { return _mm512_reduce_max_ps(a); }
+            static forcedinline float min(ParallelType a) noexcept { return _mm512_reduce_min_ps(a); }
+        };
+
+        struct Ops64
+        {
+            using ParallelType = __m512d;
+            enum
+            {
+                numParallel = 8
+            };
+
+            static forcedinline ParallelType load1(double v) noexcept { return _mm512_set1_pd(v); }
+            static forcedinline ParallelType loadU(const double* v) noexcept { return _mm512_loadu_pd(v); }
+            static forcedinline void storeU(double* dest, ParallelType a) noexcept { _mm512_storeu_pd(dest, a); }
+            static forcedinline ParallelType add(ParallelType a, ParallelType b) noexcept { return _mm512_add_pd(a, b); }
+            static forcedinline ParallelType mul(ParallelType a, ParallelType b) noexcept { return _mm512_mul_pd(a, b); }
+            static forcedinline ParallelType max(ParallelType a, ParallelType b) noexcept { return _mm512_max_pd(a, b); }
+            static forcedinline ParallelType min(ParallelType a, ParallelType b) noexcept { return _mm512_min_pd(a, b); }
+            static forcedinline ParallelType abs(ParallelType a) noexcept { return _mm512_abs_pd(a); }
+            static forcedinline double max(ParallelType a) noexcept { return _mm512_reduce_max_pd(a); }
+            static forcedinline double min(ParallelType a) noexcept { return _mm512_reduce_min_pd(a); }
+        };
+
+        JUCE_DEFINE_WIDE_KERNELS
+    } // namespace AVX512
+
+#if defined(__clang__)
+#pragma float_control(pop)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
+
+#define JUCE_DISPATCH_AVX512(kernel, ...)                       \
+    if (FloatVectorHelpers::simdLevel == FloatVectorHelpers::avx512) \
+        return FloatVectorHelpers::AVX512::kernel(__VA_ARGS__);
+#else
+#define JUCE_DISPATCH_AVX512(kernel, ...)
+#endif
+
+#undef JUCE_DEFINE_WIDE_KERNELS
+
+    /** Hands the call to the widest kernel the CPU has, otherwise falls through to the SSE loop */
+#define JUCE_DISPATCH_VEC_OP(kernel, ...)                          \
+    JUCE_DISPATCH_AVX512(kernel, __VA_ARGS__)                      \
+    if (FloatVectorHelpers::simdLevel == FloatVectorHelpers::avx2) \
+        return FloatVectorHelpers::AVX2::kernel(__VA_ARGS__);
+#else
+#define JUCE_DISPATCH_VEC_OP(kernel, ...)
 #endif
 } // namespace FloatVectorHelpers
 
@@ -828,6 +1173,7 @@ void FloatVectorOperations::copyWithMultiply(float* dest, const float* src, floa
 #if JUCE_USE_VDSP_FRAMEWORK
     vDSP_vsmul(src, 1, &multiplier, dest, 1, (vDSP_Length)num);
 #else
+    JUCE_DISPATCH_VEC_OP(multiply, dest, src, multiplier, num)
     JUCE_PERFORM_VEC_OP_SRC_DEST(dest[i] = src[i] * multiplier,
                                  Mode::mul(mult, s),
                                  JUCE_LOAD_SRC,
@@ -841,6 +1187,7 @@ void FloatVectorOperations::copyWithMultiply(double* dest, const double* src, do
 #if JUCE_USE_VDSP_FRAMEWORK
     vDSP_vsmulD(src, 1, &multiplier, dest, 1, (vDSP_Length)num);
 #else
+    JUCE_DISPATCH_VEC_OP(multiply, dest, src, multiplier, num)
     JUCE_PERFORM_VEC_OP_SRC_DEST(dest[i] = src[i] * multiplier,
                                  Mode::mul(mult, s),
                                  JUCE_LOAD_SRC,
@@ -854,6 +1201,7 @@ void FloatVectorOperations::add(float* dest, float amount, int num) noexcept
 #if JUCE_USE_VDSP_FRAMEWORK
     vDSP_vsadd(dest, 1, &amount, dest, 1, (vDSP_Length)num);
 #else
+    JUCE_DISPATCH_VEC_OP(add, dest, dest, amount, num)
     JUCE_PERFORM_VEC_OP_DEST(dest[i] += amount,
                              Mode::add(d, amountToAdd),
                              JUCE_LOAD_DEST,
@@ -863,6 +1211,7 @@ void FloatVectorOperations::add(float* dest, float amount, int num) noexcept
 
 void FloatVectorOperations::add(double* dest, double amount, int num) noexcept
 {
+    JUCE_DISPATCH_VEC_OP(add, dest, dest, amount, num)
     JUCE_PERFORM_VEC_OP_DEST(dest[i] += amount,
                              Mode::add(d, amountToAdd),
                              JUCE_LOAD_DEST,
@@ -874,6 +1223,7 @@ void FloatVectorOperations::add(float* dest, const float* src, float amount, int
 #if JUCE_USE_VDSP_FRAMEWORK
     vDSP_vsadd(osx108sdkCompatibilityCast(src), 1, &amount, dest, 1, (vDSP_Length)num);
 #else
+    JUCE_DISPATCH_VEC_OP(add, dest, src, amount, num)
     JUCE_PERFORM_VEC_OP_SRC_DEST(dest[i] = src[i] + amount,
                                  Mode::add(am, s),
                                  JUCE_LOAD_SRC,
@@ -887,6 +1237,7 @@ void FloatVectorOperations::add(double* dest, const double* src, double amount,
 #if JUCE_USE_VDSP_FRAMEWORK
     vDSP_vsaddD(osx108sdkCompatibilityCast(src), 1, &amount, dest, 1, (vDSP_Length)num);
 #else
+    JUCE_DISPATCH_VEC_OP(add, dest, src, amount, num)
     JUCE_PERFORM_VEC_OP_SRC_DEST(dest[i] = src[i] + amount,
                                  Mode::add(am, s),
                                  JUCE_LOAD_SRC,
@@ -900,6 +1251,7 @@ void FloatVectorOperations::add(float* dest, const float* src, int num) noexcept
 #if JUCE_USE_VDSP_FRAMEWORK
     vDSP_vadd(src, 1, dest, 1, dest, 1, (vDSP_Length)num);
 #else
+    JUCE_DISPATCH_VEC_OP(add, dest, dest, src, num)
     JUCE_PERFORM_VEC_OP_SRC_DEST(dest[i] += src[i], Mode::add(d, s), JUCE_LOAD_SRC_DEST, JUCE_INCREMENT_SRC_DEST, )
 #endif
 }
@@ -909,6 +1261,7 @@ void FloatVectorOperations::add(double* dest, const double* src, int num) noexce
 #if JUCE_USE_VDSP_FRAMEWORK
     vDSP_vaddD(src, 1, dest, 1, dest, 1, (vDSP_Length)num);
 #else
+    JUCE_DISPATCH_VEC_OP(add, dest, dest, src, num)
     JUCE_PERFORM_VEC_OP_SRC_DEST(dest[i] += src[i], Mode::add(d, s), JUCE_LOAD_SRC_DEST, JUCE_INCREMENT_SRC_DEST, )
 #endif
 }
@@ -918,6 +1271,7 @@ void FloatVectorOperations::add(float* dest, const float* src1, const float* src
 #if JUCE_USE_VDSP_FRAMEWORK
     vDSP_vadd(src1, 1, src2, 1, dest, 1, (vDSP_Length)num);
 #else
+    JUCE_DISPATCH_VEC_OP(add, dest, src1, src2, num)
     JUCE_PERFORM_VEC_OP_SRC1_SRC2_DEST(
         dest[i] = src1[i] + src2[i], Mode::add(s1, s2), JUCE_LOAD_SRC1_SRC2, JUCE_INCREMENT_SRC1_SRC2_DEST, )
 #endif
@@ -928,6 +1282,7 @@ void FloatVectorOperations::add(double* dest, const double* src1, const double*
 #if JUCE_USE_VDSP_FRAMEWORK
     vDSP_vaddD(src1, 1, src2, 1, dest, 1, (vDSP_Length)num);
 #else
+    JUCE_DISPATCH_VEC_OP(add, dest, src1, src2, num)
     JUCE_PERFORM_VEC_OP_SRC1_SRC2_DEST(
         dest[i] = src1[i] + src2[i], Mode::add(s1, s2), JUCE_LOAD_SRC1_SRC2, JUCE_INCREMENT_SRC1_SRC2_DEST, )
 #endif
@@ -976,6 +1331,7 @@ void FloatVectorOperations::addWithMultiply(float* dest, const float* src, float
 #if JUCE_USE_VDSP_FRAMEWORK
     vDSP_vsma(src, 1, &multiplier, dest, 1, dest, 1, (vDSP_Length)num);
 #else
+    JUCE_DISPATCH_VEC_OP(addWithMultiply, dest, src, multiplier, num)
     JUCE_PERFORM_VEC_OP_SRC_DEST(dest[i] += src[i] * multiplier,
                                  Mode::add(d, Mode::mul(mult, s)),
                                  JUCE_LOAD_SRC_DEST,
@@ -989,6 +1345,7 @@ void FloatVectorOperations::addWithMultiply(double* dest, const double* src, dou
 #if JUCE_USE_VDSP_FRAMEWORK
     vDSP_vsmaD(src, 1, &multiplier, dest, 1, dest, 1, (vDSP_Length)num);
 #else
+    JUCE_DISPATCH_VEC_OP(addWithMultiply, dest, src, multiplier, num)
     JUCE_PERFORM_VEC_OP_SRC_DEST(dest[i] += src[i] * multiplier,
                                  Mode::add(d, Mode::mul(mult, s)),
                                  JUCE_LOAD_SRC_DEST,
@@ -1002,6 +1359,7 @@ void FloatVectorOperations::addWithMultiply(float* dest, const float* src1, cons
 #if JUCE_USE_VDSP_FRAMEWORK
     vDSP_vma((float*)src1, 1, (float*)src2, 1, dest, 1, dest, 1, (vDSP_Length)num);
 #else
+    JUCE_DISPATCH_VEC_OP(addWithMultiply, dest, src1, src2, num)
     JUCE_PERFORM_VEC_OP_SRC1_SRC2_DEST_DEST(dest[i] += src1[i] * src2[i],
                                             Mode::add(d, Mode::mul(s1, s2)),
                                             JUCE_LOAD_SRC1_SRC2_DEST,
@@ -1014,6 +1372,7 @@ void FloatVectorOperations::addWithMultiply(double* dest, const double* src1, co
 #if JUCE_USE_VDSP_FRAMEWORK
     vDSP_vmaD((double*)src1, 1, (double*)src2, 1, dest, 1, dest, 1, (vDSP_Length)num);
 #else
+    JUCE_DISPATCH_VEC_OP(addWithMultiply, dest, src1, src2, num)
     JUCE_PERFORM_VEC_OP_SRC1_SRC2_DEST_DEST(dest[i] += src1[i] * src2[i],
                                             Mode::add(d, Mode::mul(s1, s2)),
                                             JUCE_LOAD_SRC1_SRC2_DEST,
@@ -1060,6 +1419,7 @@ void FloatVectorOperations::multiply(float* dest, const float* src, int num) noe
 #if JUCE_USE_VDSP_FRAMEWORK
     vDSP_vmul(src, 1, dest, 1, dest, 1, (vDSP_Length)num);
 #else
+    JUCE_DISPATCH_VEC_OP(multiply, dest, dest, src, num)
     JUCE_PERFORM_VEC_OP_SRC_DEST(dest[i] *= src[i], Mode::mul(d, s), JUCE_LOAD_SRC_DEST, JUCE_INCREMENT_SRC_DEST, )
 #endif
 }
@@ -1069,6 +1429,7 @@ void FloatVectorOperations::multiply(double* dest, const double* src, int num) n
 #if JUCE_USE_VDSP_FRAMEWORK
     vDSP_vmulD(src, 1, dest, 1, dest, 1, (vDSP_Length)num);
 #else
+    JUCE_DISPATCH_VEC_OP(multiply, dest, dest, src, num)
     JUCE_PERFORM_VEC_OP_SRC_DEST(dest[i] *= src[i], Mode::mul(d, s), JUCE_LOAD_SRC_DEST, JUCE_INCREMENT_SRC_DEST, )
 #endif
 }
@@ -1078,6 +1439,7 @@ void FloatVectorOperations::multiply(float* dest, const float* src1, const float
 #if JUCE_USE_VDSP_FRAMEWORK
     vDSP_vmul(src1, 1, src2, 1, dest, 1, (vDSP_Length)num);
 #else
+    JUCE_DISPATCH_VEC_OP(multiply, dest, src1, src2, num)
     JUCE_PERFORM_VEC_OP_SRC1_SRC2_DEST(
         dest[i] = src1[i] * src2[i], Mode::mul(s1, s2), JUCE_LOAD_SRC1_SRC2, JUCE_INCREMENT_SRC1_SRC2_DEST, )
 #endif
@@ -1088,6 +1450,7 @@ void FloatVectorOperations::multiply(double* dest, const double* src1, const dou
 #if JUCE_USE_VDSP_FRAMEWORK
     vDSP_vmulD(src1, 1, src2, 1, dest, 1, (vDSP_Length)num);
 #else
+    JUCE_DISPATCH_VEC_OP(multiply, dest, src1, src2, num)
     JUCE_PERFORM_VEC_OP_SRC1_SRC2_DEST(
         dest[i] = src1[i] * src2[i], Mode::mul(s1, s2), JUCE_LOAD_SRC1_SRC2, JUCE_INCREMENT_SRC1_SRC2_DEST, )
 #endif
@@ -1098,6 +1461,7 @@ void FloatVectorOperations::multiply(float* dest, float multiplier, int num) noe
 #if JUCE_USE_VDSP_FRAMEWORK
     vDSP_vsmul(dest, 1, &multiplier, dest, 1, (vDSP_Length)num);
 #else
+    JUCE_DISPATCH_VEC_OP(multiply, dest, dest, multiplier, num)
     JUCE_PERFORM_VEC_OP_DEST(dest[i] *= multiplier,
                              Mode::mul(d, mult),
                              JUCE_LOAD_DEST,
@@ -1110,6 +1474,7 @@ void FloatVectorOperations::multiply(double* dest, double multiplier, int num) n
 #if JUCE_USE_VDSP_FRAMEWORK
     vDSP_vsmulD(dest, 1, &multiplier, dest, 1, (vDSP_Length)num);
 #else
+    JUCE_DISPATCH_VEC_OP(multiply, dest, dest, multiplier, num)
     JUCE_PERFORM_VEC_OP_DEST(dest[i] *= multiplier,
                              Mode::mul(d, mult),
                              JUCE_LOAD_DEST,
@@ -1119,6 +1484,7 @@ void FloatVectorOperations::multiply(double* dest, double multiplier, int num) n
 
 void FloatVectorOperations::multiply(float* dest, const float* src, float multiplier, int num) noexcept
 {
+    JUCE_DISPATCH_VEC_OP(multiply, dest, src, multiplier, num)
     JUCE_PERFORM_VEC_OP_SRC_DEST(dest[i] = src[i] * multiplier,
                                  Mode::mul(mult, s),
                                  JUCE_LOAD_SRC,
@@ -1128,6 +1494,7 @@ void FloatVectorOperations::multiply(float* dest, const float* src, float multip
 
 void FloatVectorOperations::multiply(double* dest, const double* src, double multiplier, int num) noexcept
 {
+    JUCE_DISPATCH_VEC_OP(multiply, dest, src, multiplier, num)
     JUCE_PERFORM_VEC_OP_SRC_DEST(dest[i] = src[i] * multiplier,
                                  Mode::mul(mult, s),
                                  JUCE_LOAD_SRC,
@@ -1158,6 +1525,7 @@ void FloatVectorOperations::abs(float* dest, const float* src, int num) noexcept
 #if JUCE_USE_VDSP_FRAMEWORK
     vDSP_vabs((float*)src, 1, dest, 1, (vDSP_Length)num);
 #else
+    JUCE_DISPATCH_VEC_OP(abs, dest, src, num)
     FloatVectorHelpers::signMask32 signMask;
     signMask.i = 0x7fffffffUL;
     JUCE_PERFORM_VEC_OP_SRC_DEST(dest[i] = std::abs(src[i]),
@@ -1175,6 +1543,7 @@ void FloatVectorOperations::abs(double* dest, const double* src, int num) noexce
 #if JUCE_USE_VDSP_FRAMEWORK
     vDSP_vabsD((double*)src, 1, dest, 1, (vDSP_Length)num);
 #else
+    JUCE_DISPATCH_VEC_OP(abs, dest, src, num)
     FloatVectorHelpers::signMask64 signMask;
     signMask.i = 0x7fffffffffffffffULL;
 
@@ -1288,6 +1657,7 @@ void FloatVectorOperations::clip(float* dest, const float* src, float low, float
 #if JUCE_USE_VDSP_FRAMEWORK
     vDSP_vclip((float*)src, 1, &low, &high, dest, 1, (vDSP_Length)num);
 #else
+    JUCE_DISPATCH_VEC_OP(clip, dest, src, low, high, num)
     JUCE_PERFORM_VEC_OP_SRC_DEST(dest[i] = jmax(jmin(src[i], high), low),
                                  Mode::max(Mode::min(s, hi), lo),
                                  JUCE_LOAD_SRC,
@@ -1304,6 +1674,7 @@ void FloatVectorOperations::clip(double* dest, const double* src, double low, do
 #if JUCE_USE_VDSP_FRAMEWORK
     vDSP_vclipD((double*)src, 1, &low, &high, dest, 1, (vDSP_Length)num);
 #else
+    JUCE_DISPATCH_VEC_OP(clip, dest, src, low, high, num)
     JUCE_PERFORM_VEC_OP_SRC_DEST(dest[i] = jmax(jmin(src[i], high), low),
                                  Mode::max(Mode::min(s, hi), lo),
                                  JUCE_LOAD_SRC,
@@ -1316,6 +1687,7 @@ void FloatVectorOperations::clip(double* dest, const double* src, double low, do
 Range<float> FloatVectorOperations::findMinAndMax(const float* src, int num) noexcept
 {
 #if JUCE_USE_SSE_INTRINSICS || JUCE_USE_ARM_NEON
+    JUCE_DISPATCH_VEC_OP(findMinAndMax, src, num)
     return FloatVectorHelpers::MinMax<FloatVectorHelpers::BasicOps32>::findMinAndMax(src, num);
 #else
     return Range<float>::findMinAndMax(src, num);
@@ -1325,6 +1697,7 @@ Range<float> FloatVectorOperations::findMinAndMax(const float* src, int num) noe
 Range<double> FloatVectorOperations::findMinAndMax(const double* src, int num) noexcept
 {
 #if JUCE_USE_SSE_INTRINSICS || JUCE_USE_ARM_NEON
+    JUCE_DISPATCH_VEC_OP(findMinAndMax, src, num)
     return FloatVectorHelpers::MinMax<FloatVectorHelpers::BasicOps64>::findMinAndMax(src, num);
 #else
     return Range<double>::findMinAndMax(src, num);
@@ -1370,7 +1743,7 @@ double FloatVectorOperations::findMaximum(const double* src, int num) noexcept
 intptr_t FloatVectorOperations::getFpStatusRegister() noexcept
 {
     intptr_t fpsr = 0;
-#if JUCE_INTEL && JUCE_USE_SSE_INTRINSICS
+#if JUCE_USE_SSE_INTRINSICS
     fpsr = static_cast<intptr_t>(_mm_getcsr());
 #elif defined(__arm64__) || defined(__aarch64__) || JUCE_USE_ARM_NEON
 #if defined(__arm64__) || defined(__aarch64__)
@@ -1389,7 +1762,7 @@ intptr_t FloatVectorOperations::getFpStatusRegister() noexcept
 
 void FloatVectorOperations::setFpStatusRegister(intptr_t fpsr) noexcept
 {
-#if JUCE_INTEL && JUCE_USE_SSE_INTRINSICS
+#if JUCE_USE_SSE_INTRINSICS
     auto fpsr_w = static_cast<uint32_t>(fpsr);
     _mm_setcsr(fpsr_w);
 #elif defined(__arm64__) || defined(__aarch64__) || JUCE_USE_ARM_NEON
@@ -39,6 +39,15 @@
 #else
 #endif
 
+// juce_TargetPlatform.h isn't part of this subset, so the SSE paths are switched on here
+#if !defined(JUCE_USE_SSE_INTRINSICS) && (defined(__x86_64__) || defined(_M_X64))
+#define JUCE_USE_SSE_INTRINSICS 1
+#endif
+
+#if JUCE_USE_SSE_INTRINSICS
+#include <immintrin.h>
+#endif
+
 namespace juce
 {
 
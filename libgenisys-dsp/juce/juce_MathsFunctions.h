@@ -35,6 +35,15 @@
 #include <limits>
 #endif
 
+// juce_TargetPlatform.h isn't part of this subset, so the byte order is worked out here
+#if !defined(JUCE_LITTLE_ENDIAN) && !defined(JUCE_BIG_ENDIAN)
+#if (defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__) || defined(__BIG_ENDIAN__)
+#define JUCE_BIG_ENDIAN 1
+#else
+#define JUCE_LITTLE_ENDIAN 1
+#endif
+#endif
+
 namespace juce
 {
 
@@ -13,6 +13,7 @@
 
 #include "common.h"
 #include "src_config.h"
+#include "src_sinc_simd.h"
 
 #define SINC_MAGIC_MARKER MAKE_MAGIC(' ', 's', 'i', 'n', 'c', ' ')
 
@@ -25,6 +26,10 @@
 #define FP_ONE ((double)(((increment_t)1) << SHIFT_BITS))
 #define INV_FP_ONE (1.0 / FP_ONE)
 
+#if SHIFT_BITS != SINC_SIMD_SHIFT_BITS
+#error "SHIFT_BITS must match SINC_SIMD_SHIFT_BITS in src_sinc_simd.h"
+#endif
+
 /*========================================================================================
 */
 
@@ -49,6 +54,9 @@ typedef struct
 
     coeff_t const* coeffs;
 
+    /* Vectorised inner loops for this CPU, NULL to use the scalar loops. */
+    const SINC_SIMD_KERNELS* simd;
+
     int b_current, b_end, b_real_end, b_len;
 
     /* Sure hope noone does more than 128 channels at once. */
@@ -200,6 +208,8 @@ int sinc_set_converter(SRC_PRIVATE* psrc, int src_enum)
             return SRC_ERR_BAD_CONVERTER;
     };
 
+    temp_filter.simd = sinc_simd_kernels(sinc_simd_detect());
+
     /*
     ** FIXME : This needs to be looked at more closely to see if there is
     ** a better way. Need to look at prepare_data () at the same time.
@@ -275,12 +285,111 @@ static int sinc_copy(SRC_PRIVATE* from, SRC_PRIVATE* to)
 **  Beware all ye who dare pass this point. There be dragons here.
 */
 
+/*
+** Start point and tap count of each half of the filter, in the form the
+** vectorised kernels take. Taps of the left half that would read before the
+** start of filter->buffer are dropped, as the scalar loops skip them.
+*/
+typedef struct
+{
+    increment_t filter_index;
+    int data_index, count;
+} SINC_SPAN;
+
+static inline void calc_spans(SINC_FILTER* filter,
+                              increment_t increment,
+                              increment_t start_filter_index,
+                              int channels,
+                              SINC_SPAN* left,
+                              SINC_SPAN* right)
+{
+    increment_t max_filter_index = int_to_fp(filter->coeff_half_len);
+    int coeff_count, skip;
+
+    coeff_count = (max_filter_index - start_filter_index) / increment;
+    left->filter_index = start_filter_index + coeff_count * increment;
+    left->data_index = filter->b_current - channels * coeff_count;
+    left->count = left->filter_index / increment + 1;
+
+    if (left->data_index < 0)
+    {
+        skip = (channels - 1 - left->data_index) / channels;
+        left->filter_index -= skip * increment;
+        left->data_index += skip * channels;
+        left->count -= skip;
+    };
+
+    coeff_count = (max_filter_index - (increment - start_filter_index)) / increment;
+    right->filter_index = increment - start_filter_index + coeff_count * increment;
+    right->data_index = filter->b_current + channels * (1 + coeff_count);
+    right->count = right->filter_index > 0 ? (right->filter_index - 1) / increment + 1 : 1;
+} /* calc_spans */
+
+static inline void calc_output_simd_multi(SINC_FILTER* filter,
+                                          increment_t increment,
+                                          increment_t start_filter_index,
+                                          int channels,
+                                          double scale,
+                                          float* output)
+{
+    SINC_SPAN left, right;
+    int ch;
+
+    calc_spans(filter, increment, start_filter_index, channels, &left, &right);
+
+    if (left.count > 0)
+        filter->simd->multi(filter->coeffs,
+                            filter->buffer,
+                            left.filter_index,
+                            increment,
+                            left.data_index,
+                            channels,
+                            left.count,
+                            channels,
+                            filter->left_calc);
+    else
+        memset(filter->left_calc, 0, sizeof(filter->left_calc[0]) * channels);
+
+    filter->simd->multi(filter->coeffs,
+                        filter->buffer,
+                        right.filter_index,
+                        increment,
+                        right.data_index,
+                        -channels,
+                        right.count,
+                        channels,
+                        filter->right_calc);
+
+    for (ch = 0; ch < channels; ch++)
+        output[ch] = scale * (filter->left_calc[ch] + filter->right_calc[ch]);
+} /* calc_output_simd_multi */
+
 static inline double calc_output_single(SINC_FILTER* filter, increment_t increment, increment_t start_filter_index)
 {
     double fraction, left, right, icoeff;
     increment_t filter_index, max_filter_index;
     int data_index, coeff_count, indx;
 
+    if (filter->simd != NULL)
+    {
+        SINC_SPAN lspan, rspan;
+
+        calc_spans(filter, increment, start_filter_index, 1, &lspan, &rspan);
+
+        left = lspan.count > 0 ? filter->simd->mono(filter->coeffs,
+                                                     filter->buffer,
+                                                     lspan.filter_index,
+                                                     increment,
+                                                     lspan.data_index,
+                                                     1,
+                                                     lspan.count)
+                               : 0.0;
+        right = filter->simd->mono(
+            filter->coeffs, filter->buffer, rspan.filter_index, increment, rspan.data_index, -1, rspan.count);
+
+        return (left + right);
+    };
+
     /* Convert input parameters into fixed point. */
     max_filter_index = int_to_fp(filter->coeff_half_len);
 
@@ -435,6 +544,26 @@ static inline void calc_output_stereo(SINC_FILTER* filter,
     increment_t filter_index, max_filter_index;
     int data_index, coeff_count, indx;
 
+    if (filter->simd != NULL)
+    {
+        SINC_SPAN lspan, rspan;
+
+        calc_spans(filter, increment, start_filter_index, 2, &lspan, &rspan);
+
+        if (lspan.count > 0)
+            filter->simd->stereo(
+                filter->coeffs, filter->buffer, lspan.filter_index, increment, lspan.data_index, 2, lspan.count, left);
+        else
+            left[0] = left[1] = 0.0;
+
+        filter->simd->stereo(
+            filter->coeffs, filter->buffer, rspan.filter_index, increment, rspan.data_index, -2, rspan.count, right);
+
+        output[0] = scale * (left[0] + right[0]);
+        output[1] = scale * (left[1] + right[1]);
+        return;
+    };
+
     /* Convert input parameters into fixed point. */
     max_filter_index = int_to_fp(filter->coeff_half_len);
 
@@ -936,6 +1065,12 @@ static inline void calc_output_multi(SINC_FILTER* filter,
     increment_t filter_index, max_filter_index;
     int data_index, coeff_count, indx, ch;
 
+    if (filter->simd != NULL)
+    {
+        calc_output_simd_multi(filter, increment, start_filter_index, channels, scale, output);
+        return;
+    };
+
     left = filter->left_calc;
     right = filter->right_calc;
 
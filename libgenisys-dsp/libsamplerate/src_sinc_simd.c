@@ -0,0 +1,563 @@
+/*
+** Copyright (c) 2002-2016, Erik de Castro Lopo <erikd@mega-nerd.com>
+** All rights reserved.
+**
+** This code is released under 2-clause BSD license. Please see the
+** file at : https://github.com/erikd/libsamplerate/blob/master/COPYING
+*/
+
+#include <stddef.h>
+#include <string.h>
+
+#include "src_config.h"
+#include "src_sinc_simd.h"
+
+#if (defined(__x86_64__) || defined(_M_X64)) && !defined(SRC_SINC_NO_SIMD)
+#define SINC_SIMD_X86 1
+#else
+#define SINC_SIMD_X86 0
+#endif
+
+#if SINC_SIMD_X86
+
+#include <immintrin.h>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define SINC_TARGET_SSE41
+#define SINC_TARGET_AVX2
+#else
+#define SINC_TARGET_SSE41 __attribute__((target("sse4.1")))
+#define SINC_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#endif
+
+#define FP_MASK ((((int32_t)1) << SINC_SIMD_SHIFT_BITS) - 1)
+#define INV_FP_ONE (1.0 / (double)(((int32_t)1) << SINC_SIMD_SHIFT_BITS))
+
+/* Taps whose coefficients the multi channel kernels interpolate at a time. */
+#define SINC_SIMD_BLOCK 64
+
+#ifndef MIN
+#define MIN(a, b) (((a) < (b)) ? (a) : (b))
+#endif
+
+/* Same arithmetic as the scalar loops in src_sinc.c, used for the tail taps. */
+static inline double interp_coeff(const float* coeffs, int32_t filter_index)
+{
+    double fraction = (filter_index & FP_MASK) * INV_FP_ONE;
+    int indx = filter_index >> SINC_SIMD_SHIFT_BITS;
+
+    return coeffs[indx] + fraction * (coeffs[indx + 1] - coeffs[indx]);
+} /* interp_coeff */
+
+/*
+** Each tap needs coeffs[indx] and coeffs[indx + 1], so fetch them as one 64 bit
+** pair and split four pairs into the c0 and c1 vectors with two shuffles. This
+** is much cheaper than per-element inserts, and than gathers on AMD parts.
+*/
+SINC_TARGET_SSE41 static inline void load_pairs4(const float* coeffs,
+                                                 int32_t filter_index,
+                                                 int32_t increment,
+                                                 __m128* c0,
+                                                 __m128* c1)
+{
+    const float* p0 = coeffs + (filter_index >> SINC_SIMD_SHIFT_BITS);
+    const float* p1 = coeffs + ((filter_index - increment) >> SINC_SIMD_SHIFT_BITS);
+    const float* p2 = coeffs + ((filter_index - 2 * increment) >> SINC_SIMD_SHIFT_BITS);
+    const float* p3 = coeffs + ((filter_index - 3 * increment) >> SINC_SIMD_SHIFT_BITS);
+    __m128 v01 = _mm_loadh_pi(_mm_castsi128_ps(_mm_loadl_epi64((const __m128i*)p0)), (const __m64*)p1);
+    __m128 v23 = _mm_loadh_pi(_mm_castsi128_ps(_mm_loadl_epi64((const __m128i*)p2)), (const __m64*)p3);
+
+    *c0 = _mm_shuffle_ps(v01, v23, _MM_SHUFFLE(2, 0, 2, 0));
+    *c1 = _mm_shuffle_ps(v01, v23, _MM_SHUFFLE(3, 1, 3, 1));
+} /* load_pairs4 */
+
+/*========================================================================================
+**  SSE4.1 : two doubles per register.
+*/
+
+SINC_TARGET_SSE41 static inline void sse41_interp4(const float* coeffs,
+                                                   int32_t filter_index,
+                                                   int32_t increment,
+                                                   __m128i fi,
+                                                   __m128d* lo,
+                                                   __m128d* hi)
+{
+    const __m128d inv_fp_one = _mm_set1_pd(INV_FP_ONE);
+    __m128i frac = _mm_and_si128(fi, _mm_set1_epi32(FP_MASK));
+    __m128 c0, c1;
+    __m128d c0_lo, c0_hi, c1_lo, c1_hi, f_lo, f_hi;
+
+    load_pairs4(coeffs, filter_index, increment, &c0, &c1);
+
+    c0_lo = _mm_cvtps_pd(c0);
+    c0_hi = _mm_cvtps_pd(_mm_movehl_ps(c0, c0));
+    c1_lo = _mm_cvtps_pd(c1);
+    c1_hi = _mm_cvtps_pd(_mm_movehl_ps(c1, c1));
+    f_lo = _mm_mul_pd(_mm_cvtepi32_pd(frac), inv_fp_one);
+    f_hi = _mm_mul_pd(_mm_cvtepi32_pd(_mm_unpackhi_epi64(frac, frac)), inv_fp_one);
+
+    *lo = _mm_add_pd(c0_lo, _mm_mul_pd(f_lo, _mm_sub_pd(c1_lo, c0_lo)));
+    *hi = _mm_add_pd(c0_hi, _mm_mul_pd(f_hi, _mm_sub_pd(c1_hi, c0_hi)));
+} /* sse41_interp4 */
+
+SINC_TARGET_SSE41 static inline __m128i sse41_lanes(int32_t filter_index, int32_t increment)
+{
+    return _mm_sub_epi32(_mm_set1_epi32(filter_index),
+                         _mm_mullo_epi32(_mm_setr_epi32(0, 1, 2, 3), _mm_set1_epi32(increment)));
+} /* sse41_lanes */
+
+/* Interpolated coefficients for count taps, count at most SINC_SIMD_BLOCK. */
+SINC_TARGET_SSE41 static void sse41_coeff_block(
+    const float* coeffs, int32_t filter_index, int32_t increment, int count, double* icoeffs)
+{
+    __m128i fi = sse41_lanes(filter_index, increment);
+    const __m128i fi_step = _mm_set1_epi32(4 * increment);
+    __m128d lo, hi;
+    int k;
+
+    for (k = 0; k + 4 <= count; k += 4)
+    {
+        sse41_interp4(coeffs, filter_index, increment, fi, &lo, &hi);
+        _mm_storeu_pd(icoeffs + k, lo);
+        _mm_storeu_pd(icoeffs + k + 2, hi);
+
+        fi = _mm_sub_epi32(fi, fi_step);
+        filter_index -= 4 * increment;
+    };
+
+    for (; k < count; k++)
+    {
+        icoeffs[k] = interp_coeff(coeffs, filter_index);
+        filter_index -= increment;
+    };
+} /* sse41_coeff_block */
+
+SINC_TARGET_SSE41 static double sse41_mono(const float* coeffs,
+                                           const float* buffer,
+                                           int32_t filter_index,
+                                           int32_t increment,
+                                           int data_index,
+                                           int step,
+                                           int count)
+{
+    __m128i fi = sse41_lanes(filter_index, increment);
+    const __m128i fi_step = _mm_set1_epi32(4 * increment);
+    __m128d acc_lo = _mm_setzero_pd(), acc_hi = _mm_setzero_pd();
+    __m128d ic_lo, ic_hi;
+    __m128 x;
+    double sum;
+    int k;
+
+    for (k = 0; k + 4 <= count; k += 4)
+    {
+        sse41_interp4(coeffs, filter_index, increment, fi, &ic_lo, &ic_hi);
+
+        if (step > 0)
+            x = _mm_loadu_ps(buffer + data_index);
+        else
+        {
+            x = _mm_loadu_ps(buffer + data_index - 3);
+            x = _mm_shuffle_ps(x, x, _MM_SHUFFLE(0, 1, 2, 3));
+        };
+
+        acc_lo = _mm_add_pd(acc_lo, _mm_mul_pd(ic_lo, _mm_cvtps_pd(x)));
+        acc_hi = _mm_add_pd(acc_hi, _mm_mul_pd(ic_hi, _mm_cvtps_pd(_mm_movehl_ps(x, x))));
+
+        fi = _mm_sub_epi32(fi, fi_step);
+        filter_index -= 4 * increment;
+        data_index += 4 * step;
+    };
+
+    acc_lo = _mm_add_pd(acc_lo, acc_hi);
+    sum = _mm_cvtsd_f64(_mm_add_sd(acc_lo, _mm_unpackhi_pd(acc_lo, acc_lo)));
+
+    for (; k < count; k++)
+    {
+        sum += interp_coeff(coeffs, filter_index) * buffer[data_index];
+        filter_index -= increment;
+        data_index += step;
+    };
+
+    return sum;
+} /* sse41_mono */
+
+SINC_TARGET_SSE41 static void sse41_stereo(const float* coeffs,
+                                           const float* buffer,
+                                           int32_t filter_index,
+                                           int32_t increment,
+                                           int data_index,
+                                           int step,
+                                           int count,
+                                           double* sums)
+{
+    __m128i fi = sse41_lanes(filter_index, increment);
+    const __m128i fi_step = _mm_set1_epi32(4 * increment);
+    __m128d acc_a = _mm_setzero_pd(), acc_b = _mm_setzero_pd();
+    __m128d ic_lo, ic_hi;
+    const float* x;
+    int k;
+
+    for (k = 0; k + 4 <= count; k += 4)
+    {
+        sse41_interp4(coeffs, filter_index, increment, fi, &ic_lo, &ic_hi);
+        x = buffer + data_index;
+
+        /* Each tap's coefficient is applied to one L R pair. */
+        acc_a = _mm_add_pd(acc_a,
+                           _mm_mul_pd(_mm_unpacklo_pd(ic_lo, ic_lo),
+                                      _mm_cvtps_pd(_mm_castsi128_ps(_mm_loadl_epi64((const __m128i*)x)))));
+        acc_b = _mm_add_pd(acc_b,
+                           _mm_mul_pd(_mm_unpackhi_pd(ic_lo, ic_lo),
+                                      _mm_cvtps_pd(_mm_castsi128_ps(_mm_loadl_epi64((const __m128i*)(x + step))))));
+        acc_a = _mm_add_pd(acc_a,
+                           _mm_mul_pd(_mm_unpacklo_pd(ic_hi, ic_hi),
+                                      _mm_cvtps_pd(_mm_castsi128_ps(_mm_loadl_epi64((const __m128i*)(x + 2 * step))))));
+        acc_b = _mm_add_pd(acc_b,
+                           _mm_mul_pd(_mm_unpackhi_pd(ic_hi, ic_hi),
+                                      _mm_cvtps_pd(_mm_castsi128_ps(_mm_loadl_epi64((const __m128i*)(x + 3 * step))))));
+
+        fi = _mm_sub_epi32(fi, fi_step);
+        filter_index -= 4 * increment;
+        data_index += 4 * step;
+    };
+
+    acc_a = _mm_add_pd(acc_a, acc_b);
+    sums[0] = _mm_cvtsd_f64(acc_a);
+    sums[1] = _mm_cvtsd_f64(_mm_unpackhi_pd(acc_a, acc_a));
+
+    for (; k < count; k++)
+    {
+        double icoeff = interp_coeff(coeffs, filter_index);
+
+        sums[0] += icoeff * buffer[data_index];
+        sums[1] += icoeff * buffer[data_index + 1];
+        filter_index -= increment;
+        data_index += step;
+    };
+} /* sse41_stereo */
+
+SINC_TARGET_SSE41 static void sse41_multi(const float* coeffs,
+                                          const float* buffer,
+                                          int32_t filter_index,
+                                          int32_t increment,
+                                          int data_index,
+                                          int step,
+                                          int count,
+                                          int channels,
+                                          double* sums)
+{
+    double icoeffs[SINC_SIMD_BLOCK];
+    int k, n, t, ch;
+
+    memset(sums, 0, sizeof(sums[0]) * channels);
+
+    for (k = 0; k < count; k += n)
+    {
+        n = MIN(count - k, SINC_SIMD_BLOCK);
+        sse41_coeff_block(coeffs, filter_index, increment, n, icoeffs);
+
+        /* Keep each group of channels in registers across the block of taps. */
+        for (ch = 0; ch + 2 <= channels; ch += 2)
+        {
+            const float* x = buffer + data_index + ch;
+            __m128d acc = _mm_loadu_pd(sums + ch);
+
+            for (t = 0; t < n; t++)
+                acc = _mm_add_pd(acc,
+                                 _mm_mul_pd(_mm_set1_pd(icoeffs[t]),
+                                            _mm_cvtps_pd(_mm_castsi128_ps(_mm_loadl_epi64((const __m128i*)(x + t * step))))));
+
+            _mm_storeu_pd(sums + ch, acc);
+        };
+
+        if (ch < channels)
+            for (t = 0; t < n; t++)
+                sums[ch] += icoeffs[t] * buffer[data_index + ch + t * step];
+
+        filter_index -= n * increment;
+        data_index += n * step;
+    };
+} /* sse41_multi */
+
+/*========================================================================================
+**  AVX2 + FMA : four doubles per register.
+*/
+
+SINC_TARGET_AVX2 static inline __m256d avx2_interp4(const float* coeffs,
+                                                   int32_t filter_index,
+                                                   int32_t increment,
+                                                   __m128i fi)
+{
+    __m256d fraction =
+        _mm256_mul_pd(_mm256_cvtepi32_pd(_mm_and_si128(fi, _mm_set1_epi32(FP_MASK))), _mm256_set1_pd(INV_FP_ONE));
+    __m128 c0, c1;
+    __m256d d0;
+
+    load_pairs4(coeffs, filter_index, increment, &c0, &c1);
+    d0 = _mm256_cvtps_pd(c0);
+
+    return _mm256_fmadd_pd(fraction, _mm256_sub_pd(_mm256_cvtps_pd(c1), d0), d0);
+} /* avx2_interp4 */
+
+SINC_TARGET_AVX2 static inline __m128i avx2_lanes(int32_t filter_index, int32_t increment)
+{
+    return _mm_sub_epi32(_mm_set1_epi32(filter_index),
+                         _mm_mullo_epi32(_mm_setr_epi32(0, 1, 2, 3), _mm_set1_epi32(increment)));
+} /* avx2_lanes */
+
+SINC_TARGET_AVX2 static inline double avx2_hsum(__m256d v)
+{
+    __m128d half = _mm_add_pd(_mm256_castpd256_pd128(v), _mm256_extractf128_pd(v, 1));
+
+    return _mm_cvtsd_f64(_mm_add_sd(half, _mm_unpackhi_pd(half, half)));
+} /* avx2_hsum */
+
+SINC_TARGET_AVX2 static void avx2_coeff_block(
+    const float* coeffs, int32_t filter_index, int32_t increment, int count, double* icoeffs)
+{
+    __m128i fi = avx2_lanes(filter_index, increment);
+    const __m128i fi_step = _mm_set1_epi32(4 * increment);
+    int k;
+
+    for (k = 0; k + 4 <= count; k += 4)
+    {
+        _mm256_storeu_pd(icoeffs + k, avx2_interp4(coeffs, filter_index, increment, fi));
+
+        fi = _mm_sub_epi32(fi, fi_step);
+        filter_index -= 4 * increment;
+    };
+
+    for (; k < count; k++)
+    {
+        icoeffs[k] = interp_coeff(coeffs, filter_index);
+        filter_index -= increment;
+    };
+} /* avx2_coeff_block */
+
+SINC_TARGET_AVX2 static double avx2_mono(const float* coeffs,
+                                         const float* buffer,
+                                         int32_t filter_index,
+                                         int32_t increment,
+                                         int data_index,
+                                         int step,
+                                         int count)
+{
+    __m128i fi = avx2_lanes(filter_index, increment);
+    const __m128i fi_step = _mm_set1_epi32(4 * increment);
+    __m256d acc = _mm256_setzero_pd();
+    __m128 x;
+    double sum;
+    int k;
+
+    for (k = 0; k + 4 <= count; k += 4)
+    {
+        if (step > 0)
+            x = _mm_loadu_ps(buffer + data_index);
+        else
+        {
+            x = _mm_loadu_ps(buffer + data_index - 3);
+            x = _mm_shuffle_ps(x, x, _MM_SHUFFLE(0, 1, 2, 3));
+        };
+
+        acc = _mm256_fmadd_pd(avx2_interp4(coeffs, filter_index, increment, fi), _mm256_cvtps_pd(x), acc);
+
+        fi = _mm_sub_epi32(fi, fi_step);
+        filter_index -= 4 * increment;
+        data_index += 4 * step;
+    };
+
+    sum = avx2_hsum(acc);
+
+    for (; k < count; k++)
+    {
+        sum += interp_coeff(coeffs, filter_index) * buffer[data_index];
+        filter_index -= increment;
+        data_index += step;
+    };
+
+    return sum;
+} /* avx2_mono */
+
+SINC_TARGET_AVX2 static void avx2_stereo(const float* coeffs,
+                                         const float* buffer,
+                                         int32_t filter_index,
+                                         int32_t increment,
+                                         int data_index,
+                                         int step,
+                                         int count,
+                                         double* sums)
+{
+    __m128i fi = avx2_lanes(filter_index, increment);
+    const __m128i fi_step = _mm_set1_epi32(4 * increment);
+    __m256d acc_lo = _mm256_setzero_pd(), acc_hi = _mm256_setzero_pd();
+    __m128d half;
+    int k;
+
+    for (k = 0; k + 4 <= count; k += 4)
+    {
+        /* Coefficients a b c d for taps 0..3, each applied to an L R pair. */
+        __m256d ic = avx2_interp4(coeffs, filter_index, increment, fi);
+
+        if (step > 0)
+        {
+            const float* x = buffer + data_index;
+            acc_lo = _mm256_fmadd_pd(_mm256_permute4x64_pd(ic, 0x50), _mm256_cvtps_pd(_mm_loadu_ps(x)), acc_lo);
+            acc_hi = _mm256_fmadd_pd(_mm256_permute4x64_pd(ic, 0xFA), _mm256_cvtps_pd(_mm_loadu_ps(x + 4)), acc_hi);
+        }
+        else
+        {
+            /* Frames run downwards in memory, so the pairs are in reverse tap order. */
+            const float* x = buffer + data_index - 6;
+            acc_lo = _mm256_fmadd_pd(_mm256_permute4x64_pd(ic, 0xAF), _mm256_cvtps_pd(_mm_loadu_ps(x)), acc_lo);
+            acc_hi = _mm256_fmadd_pd(_mm256_permute4x64_pd(ic, 0x05), _mm256_cvtps_pd(_mm_loadu_ps(x + 4)), acc_hi);
+        };
+
+        fi = _mm_sub_epi32(fi, fi_step);
+        filter_index -= 4 * increment;
+        data_index += 4 * step;
+    };
+
+    acc_lo = _mm256_add_pd(acc_lo, acc_hi);
+    half = _mm_add_pd(_mm256_castpd256_pd128(acc_lo), _mm256_extractf128_pd(acc_lo, 1));
+    sums[0] = _mm_cvtsd_f64(half);
+    sums[1] = _mm_cvtsd_f64(_mm_unpackhi_pd(half, half));
+
+    for (; k < count; k++)
+    {
+        double icoeff = interp_coeff(coeffs, filter_index);
+
+        sums[0] += icoeff * buffer[data_index];
+        sums[1] += icoeff * buffer[data_index + 1];
+        filter_index -= increment;
+        data_index += step;
+    };
+} /* avx2_stereo */
+
+SINC_TARGET_AVX2 static void avx2_multi(const float* coeffs,
+                                        const float* buffer,
+                                        int32_t filter_index,
+                                        int32_t increment,
+                                        int data_index,
+                                        int step,
+                                        int count,
+                                        int channels,
+                                        double* sums)
+{
+    double icoeffs[SINC_SIMD_BLOCK];
+    int k, n, t, ch;
+
+    memset(sums, 0, sizeof(sums[0]) * channels);
+
+    for (k = 0; k < count; k += n)
+    {
+        n = MIN(count - k, SINC_SIMD_BLOCK);
+        avx2_coeff_block(coeffs, filter_index, increment, n, icoeffs);
+
+        /* Keep each group of channels in registers across the block of taps. */
+        for (ch = 0; ch + 4 <= channels; ch += 4)
+        {
+            const float* x = buffer + data_index + ch;
+            __m256d acc = _mm256_loadu_pd(sums + ch);
+
+            for (t = 0; t < n; t++)
+                acc = _mm256_fmadd_pd(_mm256_set1_pd(icoeffs[t]), _mm256_cvtps_pd(_mm_loadu_ps(x + t * step)), acc);
+
+            _mm256_storeu_pd(sums + ch, acc);
+        };
+
+        if (ch + 2 <= channels)
+        {
+            const float* x = buffer + data_index + ch;
+            __m128d acc = _mm_loadu_pd(sums + ch);
+
+            for (t = 0; t < n; t++)
+                acc = _mm_fmadd_pd(_mm_set1_pd(icoeffs[t]),
+                                   _mm_cvtps_pd(_mm_castsi128_ps(_mm_loadl_epi64((const __m128i*)(x + t * step)))),
+                                   acc);
+
+            _mm_storeu_pd(sums + ch, acc);
+            ch += 2;
+        };
+
+        if (ch < channels)
+            for (t = 0; t < n; t++)
+                sums[ch] += icoeffs[t] * buffer[data_index + ch + t * step];
+
+        filter_index -= n * increment;
+        data_index += n * step;
+    };
+} /* avx2_multi */
+
+static const SINC_SIMD_KERNELS sse41_kernels = { sse41_mono, sse41_stereo, sse41_multi };
+static const SINC_SIMD_KERNELS avx2_kernels = { avx2_mono, avx2_stereo, avx2_multi };
+
+static int detect_level(void)
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+
+    __cpuid(info, 0);
+    if (info[0] < 7)
+        return SRC_SIMD_NONE;
+
+    __cpuid(info, 1);
+    {
+        int sse41 = (info[2] >> 19) & 1;
+        int fma = (info[2] >> 12) & 1;
+        int os_avx = ((info[2] >> 27) & 1) && ((info[2] >> 28) & 1) && ((_xgetbv(0) & 6) == 6);
+
+        __cpuidex(info, 7, 0);
+        if (os_avx && fma && ((info[1] >> 5) & 1))
+            return SRC_SIMD_AVX2;
+
+        return sse41 ? SRC_SIMD_SSE41 : SRC_SIMD_NONE;
+    };
+#else
+    __builtin_cpu_init();
+
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+        return SRC_SIMD_AVX2;
+
+    if (__builtin_cpu_supports("sse4.1"))
+        return SRC_SIMD_SSE41;
+
+    return SRC_SIMD_NONE;
+#endif
+} /* detect_level */
+
+#endif /* SINC_SIMD_X86 */
+
+int sinc_simd_detect(void)
+{
+#if SINC_SIMD_X86
+    /* Detection is idempotent, so racing first calls simply store the same value. */
+    static volatile int level = -1;
+
+    if (level < 0)
+        level = detect_level();
+
+    return level;
+#else
+    return SRC_SIMD_NONE;
+#endif
+} /* sinc_simd_detect */
+
+const SINC_SIMD_KERNELS* sinc_simd_kernels(int level)
+{
+    switch (level)
+    {
+#if SINC_SIMD_X86
+        case SRC_SIMD_AVX2:
+            return &avx2_kernels;
+
+        case SRC_SIMD_SSE41:
+            return &sse41_kernels;
+#endif
+
+        default:
+            break;
+    };
+
+    return NULL;
+} /* sinc_simd_kernels */
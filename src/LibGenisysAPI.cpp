@@ -15,6 +15,13 @@ LibGenisysStatus LibGenisysInitialize(LibGenisysInstance instance,
     return impl->initialize(expectedBlockSize, sampleRate);
 }
 
+LibGenisysStatus LibGenisysSetDenoising(LibGenisysInstance instance,
+                                        bool shouldDenoise)
+{
+    LibGenisysImpl* impl = (LibGenisysImpl*)instance;
+    return impl->setDenoising(shouldDenoise);
+}
+
 std::string LibGenisysProcessFloat(LibGenisysInstance instance,
                                    float* audioBuffer,
                                    int numberOfSamples)
@@ -45,6 +52,162 @@ std::string LibGenisysProcessNativePath(LibGenisysInstance instance,
     return impl->processNativePath(nativeAudioFilePath);
 }
 
+LibGenisysStatus LibGenisysProcessBatch(LibGenisysInstance instance,
+                                        const char* const* nativeAudioFilePaths,
+                                        int count,
+                                        int threads,
+                                        LibGenisysBatchCallback callback,
+                                        void* userData)
+{
+    LibGenisysImpl* impl = (LibGenisysImpl*)instance;
+    return impl->processBatch(nativeAudioFilePaths, count, threads, callback, userData);
+}
+
+LibGenisysStatus LibGenisysOpenStream(LibGenisysInstance instance)
+{
+    LibGenisysImpl* impl = (LibGenisysImpl*)instance;
+    return impl->openStream();
+}
+
+LibGenisysStatus LibGenisysFeedFloat(LibGenisysInstance instance,
+                                     const float* audioBuffer,
+                                     int numberOfSamples)
+{
+    LibGenisysImpl* impl = (LibGenisysImpl*)instance;
+    return impl->feedFloat(audioBuffer, numberOfSamples);
+}
+
+LibGenisysStatus LibGenisysFeedNativeFloat(LibGenisysInstance instance,
+                                           const float* nativeAudioBuffer,
+                                           int numberOfSamples)
+{
+    LibGenisysImpl* impl = (LibGenisysImpl*)instance;
+    return impl->feedNativeFloat(nativeAudioBuffer, numberOfSamples);
+}
+
+std::string LibGenisysIntermediateDecode(LibGenisysInstance instance)
+{
+    LibGenisysImpl* impl = (LibGenisysImpl*)instance;
+    return impl->intermediateDecode();
+}
+
+std::string LibGenisysFinishStream(LibGenisysInstance instance)
+{
+    LibGenisysImpl* impl = (LibGenisysImpl*)instance;
+    return impl->finishStream();
+}
+
+void LibGenisysCancelStream(LibGenisysInstance instance)
+{
+    LibGenisysImpl* impl = (LibGenisysImpl*)instance;
+    impl->cancelStream();
+}
+
+LibGenisysStatus LibGenisysStartListening(LibGenisysInstance instance)
+{
+    LibGenisysImpl* impl = (LibGenisysImpl*)instance;
+    return impl->startListening();
+}
+
+LibGenisysStatus LibGenisysPushFloat(LibGenisysInstance instance,
+                                     const float* audioBuffer,
+                                     int numberOfSamples)
+{
+    LibGenisysImpl* impl = (LibGenisysImpl*)instance;
+    return impl->pushFloat(audioBuffer, numberOfSamples);
+}
+
+std::string LibGenisysStopListening(LibGenisysInstance instance)
+{
+    LibGenisysImpl* impl = (LibGenisysImpl*)instance;
+    return impl->stopListening();
+}
+
+LibGenisysStatus LibGenisysAddWakeWord(LibGenisysInstance instance,
+                                       const float* nativeAudioBuffer,
+                                       int numberOfSamples)
+{
+    LibGenisysImpl* impl = (LibGenisysImpl*)instance;
+    return impl->addWakeWord(nativeAudioBuffer, numberOfSamples);
+}
+
+void LibGenisysClearWakeWords(LibGenisysInstance instance)
+{
+    LibGenisysImpl* impl = (LibGenisysImpl*)instance;
+    impl->clearWakeWords();
+}
+
+LibGenisysStatus LibGenisysStartWakeWordListening(LibGenisysInstance instance,
+                                                  LibGenisysTranscriptCallback callback,
+                                                  void* userData)
+{
+    LibGenisysImpl* impl = (LibGenisysImpl*)instance;
+    return impl->startWakeWordListening(callback, userData);
+}
+
+LibGenisysStatus LibGenisysSetHotWords(LibGenisysInstance instance,
+                                       const char* hotWords)
+{
+    LibGenisysImpl* impl = (LibGenisysImpl*)instance;
+    return impl->setHotWords(hotWords);
+}
+
+LibGenisysStatus LibGenisysClearHotWords(LibGenisysInstance instance)
+{
+    LibGenisysImpl* impl = (LibGenisysImpl*)instance;
+    return impl->clearHotWords();
+}
+
+LibGenisysStatus LibGenisysSetScorerAlphaBeta(LibGenisysInstance instance,
+                                              float alpha,
+                                              float beta)
+{
+    LibGenisysImpl* impl = (LibGenisysImpl*)instance;
+    return impl->setScorerAlphaBeta(alpha, beta);
+}
+
+LibGenisysStatus LibGenisysSetTranscriptCache(LibGenisysInstance instance,
+                                              unsigned int maxEntries,
+                                              unsigned long long maxBytes)
+{
+    LibGenisysImpl* impl = (LibGenisysImpl*)instance;
+    return impl->setTranscriptCache(maxEntries, maxBytes);
+}
+
+void LibGenisysClearTranscriptCache(LibGenisysInstance instance)
+{
+    LibGenisysImpl* impl = (LibGenisysImpl*)instance;
+    impl->clearTranscriptCache();
+}
+
+LibGenisysStatus LibGenisysGetTranscriptCacheStats(LibGenisysInstance instance,
+                                                   LibGenisysCacheStats* stats)
+{
+    LibGenisysImpl* impl = (LibGenisysImpl*)instance;
+    return impl->getTranscriptCacheStats(stats);
+}
+
+LibGenisysStatus LibGenisysGetStats(LibGenisysInstance instance,
+                                    LibGenisysStageStats* stats,
+                                    int maxStages)
+{
+    LibGenisysImpl* impl = (LibGenisysImpl*)instance;
+    return impl->getStats(stats, maxStages);
+}
+
+void LibGenisysResetStats(LibGenisysInstance instance)
+{
+    LibGenisysImpl* impl = (LibGenisysImpl*)instance;
+    impl->resetStats();
+}
+
+LibGenisysStatus LibGenisysGetInputLevels(LibGenisysInstance instance,
+                                          LibGenisysInputLevels* levels)
+{
+    LibGenisysImpl* impl = (LibGenisysImpl*)instance;
+    return impl->getInputLevels(levels);
+}
+
 void LibGenisysDestroy(LibGenisysInstance instance)
 {
     LibGenisysImpl* impl = (LibGenisysImpl*)instance;
@@ -18,7 +18,13 @@ typedef enum
     LibGenisysStatusOk = 0, /**< Ok status. Represents success and no errors. */
     LibGenisysUninitialized, /** LibGenisys not yet initialized */
     LibGenisysInvalidSampleRate, /**< Invalid sample rate */
-    LibGenisysInternalError /**< Internal error */
+    LibGenisysInternalError, /**< Internal error */
+    LibGenisysStreamNotOpen, /**< No streaming session is open on the instance */
+    LibGenisysFileError, /**< Audio file could not be opened or read */
+    LibGenisysListening, /**< The instance is listening to live input, see LibGenisysStartListening */
+    LibGenisysOverrun, /**< The live input ring was full and some samples were dropped */
+    LibGenisysInvalidArgument, /**< An argument was malformed or out of range */
+    LibGenisysScorerUnavailable /**< The model was loaded without an external scorer */
 } LibGenisysStatus;
 
 /**
@@ -26,6 +32,99 @@ typedef enum
  */
 typedef void* LibGenisysInstance;
 
+/**
+ * Outcome of one file processed by LibGenisysProcessBatch
+ */
+typedef struct
+{
+    int index; /**< Position of the file in the paths array */
+    const char* path; /**< Path of the file, as passed in */
+    const char* transcript; /**< Interpreted text, only valid during the callback */
+    LibGenisysStatus status; /**< LibGenisysStatusOk, or the reason the file was skipped */
+    double audioSeconds; /**< Duration of the audio in the file */
+    double readSeconds; /**< Wall time spent loading the file */
+    double inferenceSeconds; /**< Wall time spent in DeepSpeech */
+    int cached; /**< Non-zero if the transcript came from the transcript cache */
+} LibGenisysBatchResult;
+
+/**
+ * Pipeline stages timed by each instance, in the order LibGenisysGetStats reports them
+ */
+typedef enum
+{
+    LibGenisysStageFileRead = 0, /**< Opening, mapping or reading a WAV file */
+    LibGenisysStageConversion, /**< Float to 16-bit sample conversion */
+    LibGenisysStageDenoise, /**< RNNoise */
+    LibGenisysStageResample, /**< Resampling to 16kHz */
+    LibGenisysStageFeed, /**< Feeding audio to a DeepSpeech stream, which runs feature extraction and the acoustic model */
+    LibGenisysStageDecode, /**< Decoding a transcript, including one-shot DS_SpeechToText calls */
+    LibGenisysStagePostProcess, /**< Cleaning up the decoded text */
+    LibGenisysStageWakeWord, /**< Keyword spotting while waiting for the wake word */
+    LibGenisysStageCount
+} LibGenisysStage;
+
+/**
+ * Latency distribution of one stage, in seconds
+ *
+ * Percentiles come from log-scaled buckets and are accurate to about 12%.
+ * CPU time is that of the thread that ran the stage.
+ */
+typedef struct
+{
+    LibGenisysStage stage;
+    const char* name; /**< Short lower case name of the stage, e.g. "resample" */
+    unsigned long long count; /**< Number of times the stage ran */
+    double wallTotal;
+    double wallP50;
+    double wallP95;
+    double wallP99;
+    double cpuTotal;
+    double cpuP50;
+    double cpuP95;
+    double cpuP99;
+} LibGenisysStageStats;
+
+/**
+ * Counters of the transcript cache, see LibGenisysSetTranscriptCache
+ */
+typedef struct
+{
+    unsigned long long hits; /**< Lookups answered without running inference */
+    unsigned long long misses; /**< Lookups that had to run inference */
+    unsigned long long evictions; /**< Entries dropped to stay within the limits */
+    unsigned long long entries; /**< Transcripts held now */
+    unsigned long long bytes; /**< Memory held now, including per entry bookkeeping */
+} LibGenisysCacheStats;
+
+/**
+ * Levels of the audio fed to the instance's stream, see LibGenisysGetInputLevels
+ *
+ * Measured on the input as it arrives, ahead of denoising and resampling, in
+ * frames of 10ms. Magnitudes are linear, 1.0 is full scale.
+ */
+typedef struct
+{
+    float peak; /**< Largest magnitude, held for 1.5s before it follows the signal again */
+    float maxPeak; /**< Largest magnitude since the stream was opened */
+    float rms; /**< Root mean square over the last 300ms */
+    float noiseFloorDb; /**< Estimated background level, in dB relative to full scale */
+    unsigned long long clippedSamples; /**< Samples at or beyond full scale since the stream was opened */
+    unsigned long long numSamples; /**< Samples measured since the stream was opened */
+} LibGenisysInputLevels;
+
+/**
+ * Called with the transcript of each utterance heard in wake word listening.
+ * Calls come from the library's worker thread, which is blocked until the
+ * callback returns, so it must not call back into the same instance.
+ */
+typedef void (*LibGenisysTranscriptCallback)(const char* transcript, void* userData);
+
+/**
+ * Called once per file by LibGenisysProcessBatch, in completion order.
+ * Calls are serialized, but may come from any of the worker threads.
+ */
+typedef void (*LibGenisysBatchCallback)(const LibGenisysBatchResult* result, void* userData);
+
 /**
  * Creates a library instance
  *
@@ -44,6 +143,20 @@ LibGenisysStatus EXPORT LibGenisysInitialize(LibGenisysInstance instance,
                                              int expectedBlockSize,
                                              int sampleRate);
 
+/**
+ * Switches RNNoise denoising of the input on or off
+ *
+ * Denoising runs ahead of the resampler and only applies to 48kHz input.
+ *
+ * @param instance the library instance
+ * @param shouldDenoise whether to denoise
+ *
+ * @returns the result status, LibGenisysInvalidSampleRate if the instance was
+ *          initialized at a rate other than 48kHz
+ */
+LibGenisysStatus EXPORT LibGenisysSetDenoising(LibGenisysInstance instance,
+                                               bool shouldDenoise);
+
 /**
  * Resamples an audio buffer and runs it through DeepSpeech
  *
@@ -51,7 +164,8 @@ LibGenisysStatus EXPORT LibGenisysInitialize(LibGenisysInstance instance,
  * @param audioBuffer the audio buffer
  * @param numberOfSamples the number of samples
  *
- * @returns the interpreted text string, if any
+ * @returns the interpreted text string, if any, or an empty string while the
+ *          instance is listening, see LibGenisysStartListening
  */
 std::string EXPORT LibGenisysProcessFloat(LibGenisysInstance instance,
                                           float* audioBuffer,
@@ -94,6 +208,303 @@ std::string EXPORT LibGenisysProcessPath(LibGenisysInstance instance,
 std::string EXPORT LibGenisysProcessNativePath(LibGenisysInstance instance,
                                                std::string nativeAudioFilePath);
 
+/**
+ * Transcribes a list of 16kHz files on a pool of worker threads
+ *
+ * Each worker runs its own DeepSpeech stream over the instance's shared model.
+ * The call returns once every file has been delivered to the callback.
+ *
+ * @param instance the library instance
+ * @param nativeAudioFilePaths the files to transcribe
+ * @param count the number of files
+ * @param threads the number of workers, or 0 to use one per hardware thread
+ * @param callback receives the result of each file as soon as it is done
+ * @param userData passed through to the callback
+ *
+ * @returns the result status
+ */
+LibGenisysStatus EXPORT LibGenisysProcessBatch(LibGenisysInstance instance,
+                                               const char* const* nativeAudioFilePaths,
+                                               int count,
+                                               int threads,
+                                               LibGenisysBatchCallback callback,
+                                               void* userData);
+
+/**
+ * Opens a streaming session on the instance
+ *
+ * Audio pushed with LibGenisysFeedFloat or LibGenisysFeedNativeFloat is fed to
+ * DeepSpeech as it arrives, so the transcript is ready as soon as the session is
+ * finished. Any session already open on the instance is discarded.
+ *
+ * @param instance the library instance
+ *
+ * @returns the result status
+ */
+LibGenisysStatus EXPORT LibGenisysOpenStream(LibGenisysInstance instance);
+
+/**
+ * Resamples an audio block and feeds it to the open streaming session
+ *
+ * The block must be at the sample rate passed to LibGenisysInitialize.
+ *
+ * @param instance the library instance
+ * @param audioBuffer the audio buffer
+ * @param numberOfSamples the number of samples
+ *
+ * @returns the result status
+ */
+LibGenisysStatus EXPORT LibGenisysFeedFloat(LibGenisysInstance instance,
+                                            const float* audioBuffer,
+                                            int numberOfSamples);
+
+/**
+ * Feeds a 16kHz audio block to the open streaming session
+ *
+ * @param instance the library instance
+ * @param nativeAudioBuffer the audio buffer
+ * @param numberOfSamples the number of samples
+ *
+ * @returns the result status
+ */
+LibGenisysStatus EXPORT LibGenisysFeedNativeFloat(LibGenisysInstance instance,
+                                                  const float* nativeAudioBuffer,
+                                                  int numberOfSamples);
+
+/**
+ * Decodes the audio fed so far without closing the streaming session
+ *
+ * @param instance the library instance
+ *
+ * @returns the partial transcript, or an empty string if no session is open
+ */
+std::string EXPORT LibGenisysIntermediateDecode(LibGenisysInstance instance);
+
+/**
+ * Closes the streaming session and returns its final transcript
+ *
+ * @param instance the library instance
+ *
+ * @returns the interpreted text string, if any
+ */
+std::string EXPORT LibGenisysFinishStream(LibGenisysInstance instance);
+
+/**
+ * Closes the streaming session without decoding it
+ *
+ * @param instance the library instance
+ */
+void EXPORT LibGenisysCancelStream(LibGenisysInstance instance);
+
+/**
+ * Starts listening to live input on a library-owned worker thread
+ *
+ * Opens a streaming session and allocates a ring holding two seconds of input
+ * at the rate passed to LibGenisysInitialize. Audio pushed with
+ * LibGenisysPushFloat is resampled, denoised and fed to DeepSpeech by the
+ * worker, so the audio callback never waits on any of it.
+ *
+ * While listening, the calls that touch the streaming session or the resampler
+ * return LibGenisysListening, and LibGenisysProcessFloat returns an empty string.
+ * LibGenisysIntermediateDecode may still be used.
+ *
+ * @param instance the library instance
+ *
+ * @returns the result status
+ */
+LibGenisysStatus EXPORT LibGenisysStartListening(LibGenisysInstance instance);
+
+/**
+ * Pushes a block of live input, safe to call from the audio callback
+ *
+ * Only copies the block into the preallocated ring: it never allocates, locks
+ * or makes a system call. It must be called from a single thread at a time,
+ * but may overlap LibGenisysStopListening and LibGenisysStartListening, which
+ * wait for a push in progress before touching the ring.
+ *
+ * @param instance the library instance
+ * @param audioBuffer the audio buffer, at the sample rate passed to LibGenisysInitialize
+ * @param numberOfSamples the number of samples
+ *
+ * @returns the result status, LibGenisysOverrun if the worker has fallen two
+ *          seconds behind and part of the block was dropped
+ */
+LibGenisysStatus EXPORT LibGenisysPushFloat(LibGenisysInstance instance,
+                                            const float* audioBuffer,
+                                            int numberOfSamples);
+
+/**
+ * Stops listening, feeds whatever is still in the ring and returns the final transcript
+ *
+ * @param instance the library instance
+ *
+ * @returns the interpreted text string, if any
+ */
+std::string EXPORT LibGenisysStopListening(LibGenisysInstance instance);
+
+/**
+ * Enrols a recording of the wake word for LibGenisysStartWakeWordListening
+ *
+ * Silence at either end of the recording is trimmed. Several recordings of the
+ * same speaker make the spotter more reliable.
+ *
+ * @param instance the library instance
+ * @param nativeAudioBuffer the recording at 16kHz
+ * @param numberOfSamples the number of samples
+ *
+ * @returns the result status, LibGenisysInternalError if the recording is too short
+ */
+LibGenisysStatus EXPORT LibGenisysAddWakeWord(LibGenisysInstance instance,
+                                              const float* nativeAudioBuffer,
+                                              int numberOfSamples);
+
+/**
+ * Forgets every recording enrolled with LibGenisysAddWakeWord
+ *
+ * @param instance the library instance
+ */
+void EXPORT LibGenisysClearWakeWords(LibGenisysInstance instance);
+
+/**
+ * Starts listening to live input for the wake word
+ *
+ * Works like LibGenisysStartListening, except that no DeepSpeech stream runs
+ * until a keyword spotter matches one of the enrolled wake word recordings.
+ * The stream is then fed from just before the wake word until the next pause,
+ * and its transcript is passed to the callback. With no recordings enrolled,
+ * any speech opens the stream. Either way silence costs a few microseconds per
+ * 10ms rather than a running acoustic model.
+ *
+ * Push audio with LibGenisysPushFloat and stop with LibGenisysStopListening,
+ * which returns the transcript of an utterance still in progress, if any.
+ *
+ * @param instance the library instance
+ * @param callback receives each transcript
+ * @param userData passed through to the callback
+ *
+ * @returns the result status
+ */
+LibGenisysStatus EXPORT LibGenisysStartWakeWordListening(LibGenisysInstance instance,
+                                                         LibGenisysTranscriptCallback callback,
+                                                         void* userData);
+
+/**
+ * Replaces the hot words the decoder boosts, without reloading the model
+ *
+ * Takes effect for streams opened after the call; a stream already open keeps
+ * the hot words it started with. Hot words belong to the loaded model, so
+ * every instance sharing it sees the change. Safe to call while other threads
+ * are transcribing, the call waits for any decode in progress.
+ *
+ * @param instance the library instance
+ * @param hotWords comma separated word:boost pairs, e.g. "logic:3,live:3"
+ *
+ * @returns the result status, LibGenisysInvalidArgument if the list is
+ *          malformed, in which case the current hot words are kept
+ */
+LibGenisysStatus EXPORT LibGenisysSetHotWords(LibGenisysInstance instance,
+                                              const char* hotWords);
+
+/**
+ * Removes every hot word from the model the instance uses
+ *
+ * @param instance the library instance
+ *
+ * @returns the result status
+ */
+LibGenisysStatus EXPORT LibGenisysClearHotWords(LibGenisysInstance instance);
+
+/**
+ * Sets the scorer's language model weight and word insertion bonus
+ *
+ * Applies from the next decode, including that of streams already open. Like
+ * hot words, the weights are shared by every instance using the same model.
+ *
+ * @param instance the library instance
+ * @param alpha the language model weight
+ * @param beta the word insertion bonus
+ *
+ * @returns the result status, LibGenisysScorerUnavailable if the model has no scorer
+ */
+LibGenisysStatus EXPORT LibGenisysSetScorerAlphaBeta(LibGenisysInstance instance,
+                                                     float alpha,
+                                                     float beta);
+
+/**
+ * Enables or resizes the transcript cache of the instance
+ *
+ * LibGenisysProcessFloat, LibGenisysProcessNativeFloat, LibGenisysProcessNativePath
+ * and LibGenisysProcessBatch look their audio up by a hash of its 16kHz PCM data,
+ * the model, scorer, hot words, scorer weights and output settings, and return
+ * the stored transcript without running inference when it has been seen before.
+ * Streaming sessions and live input are never cached. The cache starts disabled.
+ *
+ * @param instance the library instance
+ * @param maxEntries the most transcripts to keep, 0 disables and empties the cache
+ * @param maxBytes the most memory to hold, 0 disables and empties the cache
+ *
+ * @returns the result status
+ */
+LibGenisysStatus EXPORT LibGenisysSetTranscriptCache(LibGenisysInstance instance,
+                                                     unsigned int maxEntries,
+                                                     unsigned long long maxBytes);
+
+/**
+ * Drops every transcript held by the instance's cache, keeping its limits
+ *
+ * @param instance the library instance
+ */
+void EXPORT LibGenisysClearTranscriptCache(LibGenisysInstance instance);
+
+/**
+ * Reads the hit, miss and eviction counters and the size of the transcript cache
+ *
+ * @param instance the library instance
+ * @param stats receives the counters
+ *
+ * @returns the result status
+ */
+LibGenisysStatus EXPORT LibGenisysGetTranscriptCacheStats(LibGenisysInstance instance,
+                                                          LibGenisysCacheStats* stats);
+
+/**
+ * Reads the per-stage timings collected by the instance since it was created or last reset
+ *
+ * Safe to call from any thread while the instance is processing audio.
+ *
+ * @param instance the library instance
+ * @param stats receives one entry per stage, in LibGenisysStage order
+ * @param maxStages the size of the stats array, at most LibGenisysStageCount entries are written
+ *
+ * @returns the result status
+ */
+LibGenisysStatus EXPORT LibGenisysGetStats(LibGenisysInstance instance,
+                                           LibGenisysStageStats* stats,
+                                           int maxStages);
+
+/**
+ * Clears the per-stage timings of the instance
+ *
+ * @param instance the library instance
+ */
+void EXPORT LibGenisysResetStats(LibGenisysInstance instance);
+
+/**
+ * Reads the levels of the audio fed to the streaming session
+ *
+ * Covers LibGenisysFeedFloat, LibGenisysFeedNativeFloat and live input pushed
+ * with LibGenisysPushFloat, and restarts when a session is opened. The levels
+ * move on as audio arrives, so they need no GUI thread or timer. Safe to call
+ * from any thread while the instance is processing audio.
+ *
+ * @param instance the library instance
+ * @param levels receives the levels
+ *
+ * @returns the result status
+ */
+LibGenisysStatus EXPORT LibGenisysGetInputLevels(LibGenisysInstance instance,
+                                                 LibGenisysInputLevels* levels);
+
 /**
  * Destroys the library instance and deallocates the memory.
  *
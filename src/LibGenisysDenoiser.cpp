@@ -0,0 +1,66 @@
+#include "LibGenisysDenoiser.h"
+
+#include "juce/juce_FloatVectorOperations.h"
+
+#include <algorithm>
+
+LibGenisysDenoiser::LibGenisysDenoiser()
+{
+    //Use the default model
+    st = rnnoise_create(NULL);
+}
+
+LibGenisysDenoiser::~LibGenisysDenoiser()
+{
+    rnnoise_destroy(st);
+}
+
+void LibGenisysDenoiser::prepare(int maxBlockSize)
+{
+    voiceProbabilities.reserve(size_t(maxBlockSize / frameSize + 2));
+}
+
+void LibGenisysDenoiser::reset()
+{
+    juce::FloatVectorOperations::clear(inputFrame, frameSize);
+    juce::FloatVectorOperations::clear(outputFrame, frameSize);
+    framePosition = 0;
+    voiceProbabilities.clear();
+}
+
+void LibGenisysDenoiser::resetModelState()
+{
+    //rnnoise_init allocates fresh GRU state without freeing the old, so start over with a new state
+    rnnoise_destroy(st);
+    st = rnnoise_create(NULL);
+    reset();
+}
+
+void LibGenisysDenoiser::process(const float* input, float* output, int numSamples)
+{
+    while (numSamples > 0)
+    {
+        const int todo = std::min(numSamples, frameSize - framePosition);
+
+        //Read the input before writing the output so in-place processing works
+        juce::FloatVectorOperations::copyWithMultiply(inputFrame + framePosition, input, 32768.0f, todo);
+        juce::FloatVectorOperations::copyWithMultiply(output, outputFrame + framePosition, 1.0f / 32768.0f, todo);
+
+        framePosition += todo;
+        input += todo;
+        output += todo;
+        numSamples -= todo;
+
+        if (framePosition == frameSize)
+        {
+            voiceProbabilities.push_back(rnnoise_process_frame(st, outputFrame, inputFrame));
+            framePosition = 0;
+        }
+    }
+}
+
+void LibGenisysDenoiser::flush(float* output)
+{
+    float silence[frameSize] = {};
+    process(silence, output, frameSize);
+}
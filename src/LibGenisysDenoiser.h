@@ -0,0 +1,57 @@
+#pragma once
+
+#include "rnnoise.h"
+
+#include <vector>
+
+/**
+ * RNNoise denoising stage for 48kHz mono audio in the [-1, 1] float range
+ *
+ * RNNoise only works on whole 480 sample frames, so input is collected into a
+ * frame and any remainder is carried over to the next call. Each output sample
+ * comes from the previous frame, giving a fixed latency of one frame whatever
+ * the block size. All scratch space is allocated up front by prepare().
+ */
+class LibGenisysDenoiser
+{
+public:
+    static constexpr int sampleRate = 48000;
+    static constexpr int frameSize = 480;
+
+    LibGenisysDenoiser();
+    ~LibGenisysDenoiser();
+
+    /** Allocates room for the voice probabilities of a block of up to maxBlockSize samples */
+    void prepare(int maxBlockSize);
+
+    /** Clears the carried-over frame and the voice probabilities, without allocating */
+    void reset();
+
+    /** Also clears RNNoise's recurrent state, which allocates so keep it off the per-call path */
+    void resetModelState();
+
+    /**
+     * Denoises numSamples samples. input and output may be the same buffer.
+     * The voice probability of every frame completed during the call is appended
+     * to getVoiceProbabilities().
+     */
+    void process(const float* input, float* output, int numSamples);
+
+    /** Pushes one frame of silence through so the last real frame is emitted into output */
+    void flush(float* output);
+
+    int getLatencyInSamples() const noexcept { return frameSize; }
+
+    const std::vector<float>& getVoiceProbabilities() const noexcept { return voiceProbabilities; }
+    void clearVoiceProbabilities() noexcept { voiceProbabilities.clear(); }
+
+private:
+    DenoiseState* st = nullptr;
+
+    //Input is scaled to the 16 bit range RNNoise expects, output is RNNoise's raw result
+    float inputFrame[frameSize] = {};
+    float outputFrame[frameSize] = {};
+    int framePosition = 0;
+
+    std::vector<float> voiceProbabilities;
+};
@@ -2,63 +2,39 @@
 
 LibGenisysImpl::LibGenisysImpl()
 {
-    // RNNoise
-    //Use the default model (must be done before registering the callback below)
-    st = rnnoise_create(NULL);
-
     //CFURLRef pbmmUrlRef = CFBundleCopyResourceURL(CFBundleGetMainBundle(),
     //                                              CFSTR("deepspeech-0.9.3-models.pbmm"),
     //                                             NULL, NULL);
     //const char* pbmmPtr = CFStringGetCStringPtr(CFURLGetString(pbmmUrlRef),kCFStringEncodingUTF8);
-    //int status = DS_CreateModel(pbmmPtr, &ctx);
-    //int status = DS_CreateModel(PBMM_PATH, &ctx);
-    int status = DS_CreateModel("/usr/local/bin/deepspeech-0.9.3-models.pbmm", &ctx);
-    if (status != 0)
-    {
-        /*TODO: Post failure reason */
-        return;
-    }
-
     //CFURLRef scorerUrlRef = CFBundleCopyResourceURL(CFBundleGetMainBundle(), CFSTR("deepspeech-0.9.3-models.scorer"),
     //                                             NULL, NULL);
     //const char* scorerPtr = CFStringGetCStringPtr(CFURLGetString(scorerUrlRef),kCFStringEncodingUTF8);
-    //status = DS_EnableExternalScorer(ctx, scorerPtr);
-    //status = DS_EnableExternalScorer(ctx, SCORER_PATH);
-    status = DS_EnableExternalScorer(ctx, "/usr/local/bin/deepspeech-0.9.3-models.scorer");
-    if (status != 0)
+    //model = LibGenisysModel::acquire(PBMM_PATH, SCORER_PATH, hot_words);
+
+    //Every instance with the same model and scorer shares one loaded ModelState
+    model = LibGenisysModel::acquire("/usr/local/bin/deepspeech-0.9.3-models.pbmm",
+                                     "/usr/local/bin/deepspeech-0.9.3-models.scorer",
+                                     hot_words);
+    if (!model)
     {
-        /*TODO: Report failure reason */
+        /*TODO: Post failure reason */
         return;
     }
 
-    if (hot_words)
-    {
-        std::vector<std::string> hot_words_ = SplitStringOnDelim(hot_words, ",");
-        for ( std::string hot_word_ : hot_words_ )
-        {
-            std::vector<std::string> pair_ = SplitStringOnDelim(hot_word_, ":");
-            const char* word = (pair_[0]).c_str();
-            // the strtof function will return 0 in case of non numeric characters
-            // so, check the boost string before we turn it into a float
-            bool boost_is_valid = (pair_[1].find_first_not_of("-.0123456789") == std::string::npos);
-            float boost = strtof((pair_[1]).c_str(),0);
-            status = DS_AddHotWord(ctx, word, boost);
-            if (status != 0 || !boost_is_valid)
-            {
-                /*TODO: Report failure reason */
-                return;
-            }
-        }
-    }
+    ctx = model->get();
 }
 
 LibGenisysImpl::~LibGenisysImpl()
 {
-    rnnoise_destroy(st);
+    StopLiveWorker();
+    cancelStream();
 }
 
 LibGenisysStatus LibGenisysImpl::initialize(int expectedBlockSize, int sampleRate)
 {
+    if (IsListening())
+        return LibGenisysListening;
+
     if (sampleRate < 16000)
     {
         fprintf(stderr, "Warning: original sample rate (%d) is lower than %dkHz. "
@@ -70,6 +46,9 @@ LibGenisysStatus LibGenisysImpl::initialize(int expectedBlockSize, int sampleRat
         currentBlockSize = expectedBlockSize;
         const int resamplerMaxSamples = maxInputSampleRate * 2;
         inputResampler = std::make_unique<ResamplingFifo>(expectedBlockSize, 1, resamplerMaxSamples);
+
+        //Device rates are fixed, so 48k and 44.1k take the precomputed polyphase path
+        inputResampler->setEngine(ResamplingFifo::Engine::polyphase);
     }
     else if (currentBlockSize != expectedBlockSize)
     {
@@ -84,17 +63,751 @@ LibGenisysStatus LibGenisysImpl::initialize(int expectedBlockSize, int sampleRat
         inputResampler->reset();
     }
 
+    //Room for everything the resampler can hold, so a single read always drains it
+    nativeBuffer.resize(size_t(maxInputSampleRate * 2));
+
+    denoisedBuffer.setSize(1, std::max(currentBlockSize, LibGenisysDenoiser::frameSize), false, false, true);
+    denoiser.prepare(currentBlockSize);
+    denoiser.resetModelState();
+
     return LibGenisysStatusOk;
 }
 
 std::string LibGenisysImpl::processFloat(float* buffer, int numSamples)
 {
-    return "";
+    if (!inputResampler)
+        return "";
+
+    //The live worker owns the resampler and denoiser, and in wake word listening assigns the stream
+    if (IsListening())
+        return "";
+
+    if (stream)
+    {
+        std::cerr << "processFloat called while a streaming session is open" << std::endl;
+        return "";
+    }
+
+    inputResampler->reset();
+
+    const bool runDenoiser = UsesDenoiser();
+    if (runDenoiser)
+        denoiser.reset();
+
+    //The denoiser's first frame out is silence, dropping it keeps its voice probabilities aligned with the audio
+    int samplesToSkip = runDenoiser && denoising ? denoiser.getLatencyInSamples() : 0;
+
+    std::vector<short> utterance;
+    utterance.reserve(size_t(numSamples) * targetSampleRate / std::max(currentInputSampleRate, 1) + 1);
+
+    auto resampleIntoUtterance = [&](const float* block, int blockSize)
+    {
+        const int skipped = std::min(samplesToSkip, blockSize);
+        samplesToSkip -= skipped;
+
+        const int numResampled = ResampleBlock(block + skipped, blockSize - skipped);
+        utterance.insert(utterance.end(), nativeBuffer.begin(), nativeBuffer.begin() + numResampled);
+    };
+
+    for (int offset = 0; offset < numSamples; offset += currentBlockSize)
+    {
+        const int blockSize = std::min(currentBlockSize, numSamples - offset);
+        const float* block = buffer + offset;
+
+        if (runDenoiser)
+            block = DenoiseBlock(block, blockSize);
+
+        resampleIntoUtterance(block, blockSize);
+    }
+
+    if (runDenoiser && denoising)
+    {
+        {
+            LibGenisysStats::Timer timer(stats, LibGenisysStageDenoise);
+            denoiser.flush(denoisedBuffer.getWritePointer(0));
+        }
+        resampleIntoUtterance(denoisedBuffer.getReadPointer(0), denoiser.getLatencyInSamples());
+    }
+
+    const int numFlushed = FlushResampler();
+    utterance.insert(utterance.end(), nativeBuffer.begin(), nativeBuffer.begin() + numFlushed);
+
+    //RNNoise's 10ms frames at 48kHz line up with the endpointer's 10ms frames at 16kHz
+    const auto& probabilities = denoiser.getVoiceProbabilities();
+    const bool useProbabilities = runDenoiser && endpointing && !probabilities.empty();
+
+    return ProcessNativeSamples(ctx,
+                                utterance.data(),
+                                utterance.size(),
+                                useProbabilities ? probabilities.data() : nullptr,
+                                useProbabilities ? (int)probabilities.size() : 0);
+}
+
+bool LibGenisysImpl::UsesDenoiser() const
+{
+    return (denoising || endpointing) && currentInputSampleRate == LibGenisysDenoiser::sampleRate;
+}
+
+const float* LibGenisysImpl::DenoiseBlock(const float* buffer, int numSamples)
+{
+    LibGenisysStats::Timer timer(stats, LibGenisysStageDenoise);
+    denoiser.process(buffer, denoisedBuffer.getWritePointer(0), numSamples);
+    return denoising ? denoisedBuffer.getReadPointer(0) : buffer;
+}
+
+LibGenisysStatus LibGenisysImpl::setHotWords(const char* hotWordList)
+{
+    if (!model)
+        return LibGenisysUninitialized;
+
+    return model->setHotWords(hotWordList);
+}
+
+LibGenisysStatus LibGenisysImpl::clearHotWords()
+{
+    if (!model)
+        return LibGenisysUninitialized;
+
+    return model->clearHotWords();
+}
+
+LibGenisysStatus LibGenisysImpl::setScorerAlphaBeta(float alpha, float beta)
+{
+    if (!model)
+        return LibGenisysUninitialized;
+
+    return model->setScorerAlphaBeta(alpha, beta);
+}
+
+LibGenisysStatus LibGenisysImpl::setDenoising(bool shouldDenoise)
+{
+    if (IsListening())
+        return LibGenisysListening;
+
+    denoising = shouldDenoise;
+    denoiser.resetModelState();
+
+    if (shouldDenoise && currentInputSampleRate != 0 && currentInputSampleRate != LibGenisysDenoiser::sampleRate)
+        return LibGenisysInvalidSampleRate;
+
+    return LibGenisysStatusOk;
 }
 
 std::string LibGenisysImpl::processNativeFloat(float* buffer, int numSamples)
 {
-    return "";
+    std::vector<short> utterance(size_t(std::max(numSamples, 0)));
+    {
+        LibGenisysStats::Timer timer(stats, LibGenisysStageConversion);
+        juce::AudioDataConverters::convertFloatToInt16LE(buffer, utterance.data(), numSamples);
+    }
+
+    return ProcessNativeSamples(ctx, utterance.data(), utterance.size());
+}
+
+LibGenisysStatus LibGenisysImpl::getStats(LibGenisysStageStats* out, int maxStages) const
+{
+    if (!out && maxStages > 0)
+        return LibGenisysInternalError;
+
+    stats.get(out, maxStages);
+    return LibGenisysStatusOk;
+}
+
+void LibGenisysImpl::resetStats()
+{
+    stats.reset();
+}
+
+LibGenisysStatus LibGenisysImpl::getInputLevels(LibGenisysInputLevels* out) const
+{
+    if (!out)
+        return LibGenisysInternalError;
+
+    const auto levels = inputMeter.getLevels();
+    out->peak = levels.peak;
+    out->maxPeak = levels.maxPeak;
+    out->rms = levels.rms;
+    out->noiseFloorDb = levels.noiseFloorDb;
+    out->clippedSamples = levels.clippedSamples;
+    out->numSamples = levels.numSamples;
+    return LibGenisysStatusOk;
+}
+
+void LibGenisysImpl::MeterInput(const float* buffer, int numSamples, int sampleRate)
+{
+    inputMeter.setSampleRate(sampleRate);
+    inputMeter.process(buffer, numSamples);
+}
+
+LibGenisysStatus LibGenisysImpl::setTranscriptCache(unsigned int maxEntries, unsigned long long maxBytes)
+{
+    transcriptCache.setLimits(maxEntries, (size_t)std::min<unsigned long long>(maxBytes, std::numeric_limits<size_t>::max()));
+    return LibGenisysStatusOk;
+}
+
+void LibGenisysImpl::clearTranscriptCache()
+{
+    transcriptCache.clear();
+}
+
+LibGenisysStatus LibGenisysImpl::getTranscriptCacheStats(LibGenisysCacheStats* out) const
+{
+    if (!out)
+        return LibGenisysInternalError;
+
+    transcriptCache.getStats(*out);
+    return LibGenisysStatusOk;
+}
+
+LibGenisysTranscriptCache::Key LibGenisysImpl::TranscriptCacheKey(CacheSource source,
+                                                                  const void* pcm,
+                                                                  size_t numBytes,
+                                                                  const float* voiceProbabilities,
+                                                                  int numProbabilities) const
+{
+    const uint64_t settings[] = {
+        (uint64_t)source,
+        (uint64_t)endpointing,
+        (uint64_t)extended_metadata,
+        (uint64_t)json_output,
+        (uint64_t)json_candidate_transcripts,
+        (uint64_t)stream_size,
+        (uint64_t)extended_stream_size,
+    };
+    uint64_t seed = LibGenisysTranscriptCache::hash(settings, sizeof(settings));
+
+    //RNNoise's voice probabilities move the segment boundaries
+    if (voiceProbabilities && numProbabilities > 0)
+        seed = LibGenisysTranscriptCache::hash(voiceProbabilities, size_t(numProbabilities) * sizeof(float), seed);
+
+    return LibGenisysTranscriptCache::makeKey(pcm, numBytes, seed, model->getConfigurationHash());
+}
+
+void LibGenisysImpl::CacheTranscript(const LibGenisysTranscriptCache::Key& key, const std::string& transcript)
+{
+    //Hot words or scorer weights changed during inference, the transcript may match neither set
+    if (key.configuration != model->getConfigurationHash())
+        return;
+
+    transcriptCache.insert(key, transcript);
+}
+
+void LibGenisysImpl::FeedStream(StreamingState* target, const short* buffer, unsigned int numSamples)
+{
+    //Feeding runs the decoder over the new frames, so it reads the scorer weights too
+    const auto decoding = model->lockForDecoding();
+    LibGenisysStats::Timer timer(stats, LibGenisysStageFeed);
+    DS_FeedAudioContent(target, buffer, numSamples);
+}
+
+int LibGenisysImpl::CreateStream(ModelState* context, StreamingState** target)
+{
+    //The stream takes a copy of the model's hot words
+    const auto decoding = model->lockForDecoding();
+    return DS_CreateStream(context, target);
+}
+
+LibGenisysStatus LibGenisysImpl::openStream()
+{
+    if (!ctx)
+        return LibGenisysUninitialized;
+
+    if (IsListening())
+        return LibGenisysListening;
+
+    cancelStream();
+
+    if (inputResampler)
+        inputResampler->reset();
+
+    denoiser.reset();
+    inputMeter.reset();
+
+    if (CreateStream(ctx, &stream) != DS_ERR_OK)
+    {
+        stream = nullptr;
+        return LibGenisysInternalError;
+    }
+
+    return LibGenisysStatusOk;
+}
+
+LibGenisysStatus LibGenisysImpl::feedFloat(const float* buffer, int numSamples)
+{
+    if (!inputResampler)
+        return LibGenisysUninitialized;
+
+    if (IsListening())
+        return LibGenisysListening;
+
+    if (!stream)
+        return LibGenisysStreamNotOpen;
+
+    FeedResampled(buffer, numSamples);
+    return LibGenisysStatusOk;
+}
+
+void LibGenisysImpl::FeedResampled(const float* buffer, int numSamples)
+{
+    MeterInput(buffer, numSamples, currentInputSampleRate);
+
+    const bool runDenoiser = denoising && currentInputSampleRate == LibGenisysDenoiser::sampleRate;
+
+    for (int offset = 0; offset < numSamples; offset += currentBlockSize)
+    {
+        const int blockSize = std::min(currentBlockSize, numSamples - offset);
+        const float* block = buffer + offset;
+
+        if (runDenoiser)
+        {
+            block = DenoiseBlock(block, blockSize);
+            denoiser.clearVoiceProbabilities();
+        }
+
+        const int numResampled = ResampleBlock(block, blockSize);
+
+        if (numResampled <= 0)
+            continue;
+
+        if (wakeWordGating)
+            GateNative(nativeBuffer.data(), numResampled);
+        else
+            FeedStream(stream, nativeBuffer.data(), (unsigned int)numResampled);
+    }
+}
+
+LibGenisysStatus LibGenisysImpl::feedNativeFloat(const float* buffer, int numSamples)
+{
+    if (IsListening())
+        return LibGenisysListening;
+
+    if (!stream)
+        return LibGenisysStreamNotOpen;
+
+    if (nativeBuffer.empty())
+        nativeBuffer.resize(size_t(maxInputSampleRate * 2));
+
+    MeterInput(buffer, numSamples, targetSampleRate);
+
+    const int chunkSize = (int)nativeBuffer.size();
+
+    for (int offset = 0; offset < numSamples; offset += chunkSize)
+    {
+        const int numConverted = ConvertToNative(buffer + offset, std::min(chunkSize, numSamples - offset));
+        FeedStream(stream, nativeBuffer.data(), (unsigned int)numConverted);
+    }
+
+    return LibGenisysStatusOk;
+}
+
+std::string LibGenisysImpl::intermediateDecode()
+{
+    //Keeps the live worker from feeding the stream while it is decoded
+    const std::lock_guard<std::mutex> lock(liveLock);
+
+    if (!stream)
+        return "";
+
+    char* transcript;
+    {
+        const auto decoding = model->lockForDecoding();
+        LibGenisysStats::Timer timer(stats, LibGenisysStageDecode);
+        transcript = DS_IntermediateDecode(stream);
+    }
+
+    return PostProcessTranscript(transcript);
+}
+
+std::string LibGenisysImpl::finishStream()
+{
+    if (IsListening())
+        return "";
+
+    return FinishStream();
+}
+
+std::string LibGenisysImpl::FinishStream()
+{
+    if (!stream)
+        return "";
+
+    //Push out the frame the denoiser is still holding
+    if (inputResampler && denoising && currentInputSampleRate == LibGenisysDenoiser::sampleRate)
+    {
+        {
+            LibGenisysStats::Timer timer(stats, LibGenisysStageDenoise);
+            denoiser.flush(denoisedBuffer.getWritePointer(0));
+        }
+        const int numResampled = ResampleBlock(denoisedBuffer.getReadPointer(0), denoiser.getLatencyInSamples());
+
+        if (numResampled > 0)
+            FeedStream(stream, nativeBuffer.data(), (unsigned int)numResampled);
+    }
+
+    //And the last few milliseconds still inside the resampler's filter
+    if (inputResampler)
+    {
+        const int numFlushed = FlushResampler();
+
+        if (numFlushed > 0)
+            FeedStream(stream, nativeBuffer.data(), (unsigned int)numFlushed);
+    }
+
+    //DS_FinishStream releases the stream
+    char* transcript;
+    {
+        const auto decoding = model->lockForDecoding();
+        LibGenisysStats::Timer timer(stats, LibGenisysStageDecode);
+        transcript = DS_FinishStream(stream);
+    }
+    stream = nullptr;
+
+    return PostProcessTranscript(transcript);
+}
+
+void LibGenisysImpl::cancelStream()
+{
+    if (stream && !IsListening())
+    {
+        DS_FreeStream(stream);
+        stream = nullptr;
+    }
+}
+
+LibGenisysStatus LibGenisysImpl::startListening()
+{
+    if (!inputResampler)
+        return LibGenisysUninitialized;
+
+    if (IsListening())
+        return LibGenisysListening;
+
+    const auto status = openStream();
+    if (status != LibGenisysStatusOk)
+        return status;
+
+    wakeWordGating = false;
+    StartLiveWorker();
+
+    return LibGenisysStatusOk;
+}
+
+void LibGenisysImpl::StartLiveWorker()
+{
+    //A push from before the last stop may still be copying into the ring
+    WaitForPushes();
+
+    //Kept between sessions, so a restart at the same rate allocates nothing
+    const int capacity = std::max(int(currentInputSampleRate * liveRingSeconds), currentBlockSize * 4) + 1;
+    if ((int)liveRing.size() != capacity)
+    {
+        liveRing.assign(size_t(capacity), 0.0f);
+        liveFifo.setTotalSize(capacity);
+    }
+    else
+    {
+        liveFifo.reset();
+    }
+
+    liveStopRequested = false;
+    liveWorker = std::thread(&LibGenisysImpl::LiveWorkerLoop, this);
+    listening.store(true, std::memory_order_release);
+}
+
+LibGenisysStatus LibGenisysImpl::pushFloat(const float* buffer, int numSamples)
+{
+    //Runs on the audio thread, so only atomics and a copy into memory allocated up front
+    //Counted in before checking listening, so a stop either sees this push or this push sees the stop
+    pushesInFlight.fetch_add(1);
+    if (!listening.load())
+    {
+        pushesInFlight.fetch_sub(1, std::memory_order_release);
+        return LibGenisysStreamNotOpen;
+    }
+
+    int start1, size1, start2, size2;
+    liveFifo.prepareToWrite(numSamples, start1, size1, start2, size2);
+
+    std::copy(buffer, buffer + size1, liveRing.data() + start1);
+    std::copy(buffer + size1, buffer + size1 + size2, liveRing.data() + start2);
+
+    liveFifo.finishedWrite(size1 + size2);
+    pushesInFlight.fetch_sub(1, std::memory_order_release);
+
+    return size1 + size2 < numSamples ? LibGenisysOverrun : LibGenisysStatusOk;
+}
+
+std::string LibGenisysImpl::stopListening()
+{
+    if (!IsListening())
+        return "";
+
+    StopLiveWorker();
+
+    //Anything pushed after the worker's last pass
+    DrainLiveRing();
+    wakeWordGating = false;
+
+    return FinishStream();
+}
+
+void LibGenisysImpl::StopLiveWorker()
+{
+    if (!IsListening())
+        return;
+
+    listening.store(false);
+    WaitForPushes();
+
+    {
+        const std::lock_guard<std::mutex> lock(liveLock);
+        liveStopRequested = true;
+    }
+
+    liveWakeup.notify_one();
+    liveWorker.join();
+}
+
+void LibGenisysImpl::WaitForPushes()
+{
+    //A push copies at most one block, so this spins for microseconds at worst
+    while (pushesInFlight.load(std::memory_order_acquire) != 0)
+        std::this_thread::yield();
+}
+
+void LibGenisysImpl::LiveWorkerLoop()
+{
+    //The audio thread never signals, it would have to lock or make a system call, so the worker polls
+    std::unique_lock<std::mutex> lock(liveLock);
+
+    while (!liveStopRequested)
+    {
+        liveWakeup.wait_for(lock, livePollInterval, [this] { return liveStopRequested; });
+        DrainLiveRing();
+    }
+}
+
+void LibGenisysImpl::DrainLiveRing()
+{
+    int start1, size1, start2, size2;
+    liveFifo.prepareToRead(liveFifo.getTotalSize(), start1, size1, start2, size2);
+
+    //Fed straight from the ring, FeedResampled splits it into blocks the resampler and denoiser were sized for
+    if (size1 > 0)
+        FeedResampled(liveRing.data() + start1, size1);
+    if (size2 > 0)
+        FeedResampled(liveRing.data() + start2, size2);
+
+    liveFifo.finishedRead(size1 + size2);
+}
+
+LibGenisysStatus LibGenisysImpl::addWakeWord(const float* buffer, int numSamples)
+{
+    if (IsListening())
+        return LibGenisysListening;
+
+    std::vector<short> recording(size_t(std::max(numSamples, 0)));
+    juce::AudioDataConverters::convertFloatToInt16LE(buffer, recording.data(), numSamples);
+
+    return keywordSpotter.addTemplate(recording.data(), numSamples) ? LibGenisysStatusOk : LibGenisysInternalError;
+}
+
+void LibGenisysImpl::clearWakeWords()
+{
+    if (!IsListening())
+        keywordSpotter.clearTemplates();
+}
+
+LibGenisysStatus LibGenisysImpl::startWakeWordListening(LibGenisysTranscriptCallback callback, void* userData)
+{
+    if (!ctx || !inputResampler)
+        return LibGenisysUninitialized;
+
+    if (IsListening())
+        return LibGenisysListening;
+
+    cancelStream();
+    inputResampler->reset();
+    denoiser.reset();
+    inputMeter.reset();
+
+    wakeWordCallback = callback;
+    wakeWordUserData = userData;
+
+    keywordSpotter.reset();
+    gateEndpointer.reset();
+
+    gatePreRoll.assign(size_t(targetSampleRate * wakeWordPreRollMs / 1000), 0);
+    gatePreRollWrite = gatePreRollSize = 0;
+    gateFrame.assign(size_t(keywordSpotter.getFrameSize()), 0);
+    gateFrameFill = 0;
+
+    wakeWordGating = true;
+    StartLiveWorker();
+
+    return LibGenisysStatusOk;
+}
+
+void LibGenisysImpl::GateNative(const short* buffer, int numSamples)
+{
+    const int frameSize = (int)gateFrame.size();
+
+    //Whole frames are gated in place, only a partial frame at either end is copied
+    int offset = 0;
+    if (gateFrameFill > 0)
+    {
+        const int numToCopy = std::min(frameSize - gateFrameFill, numSamples);
+        std::copy(buffer, buffer + numToCopy, gateFrame.data() + gateFrameFill);
+        gateFrameFill += numToCopy;
+        offset = numToCopy;
+
+        if (gateFrameFill < frameSize)
+            return;
+
+        GateFrame(gateFrame.data(), frameSize);
+        gateFrameFill = 0;
+    }
+
+    for (; offset + frameSize <= numSamples; offset += frameSize)
+        GateFrame(buffer + offset, frameSize);
+
+    std::copy(buffer + offset, buffer + numSamples, gateFrame.data());
+    gateFrameFill = numSamples - offset;
+}
+
+void LibGenisysImpl::GateFrame(const short* frame, int frameSize)
+{
+    const bool speech = gateEndpointer.isSpeechFrame(frame, frameSize);
+
+    if (stream)
+    {
+        FeedStream(stream, frame, (unsigned int)frameSize);
+
+        gateSilentFrames = speech ? 0 : gateSilentFrames + 1;
+        ++gateUtteranceFrames;
+
+        const int frameMs = keywordSpotter.getSettings().frameMs;
+        if (gateSilentFrames * frameMs >= gateEndpointer.getSettings().splitPauseMs || gateUtteranceFrames * frameMs >= maxUtteranceMs)
+            FinishGatedUtterance();
+
+        return;
+    }
+
+    const int preRollCapacity = (int)gatePreRoll.size();
+    for (int i = 0; i < frameSize; ++i)
+    {
+        gatePreRoll[size_t(gatePreRollWrite)] = frame[i];
+        gatePreRollWrite = gatePreRollWrite + 1 == preRollCapacity ? 0 : gatePreRollWrite + 1;
+    }
+    gatePreRollSize = std::min(gatePreRollSize + frameSize, preRollCapacity);
+
+    if (keywordSpotter.getNumTemplates() == 0)
+    {
+        //Without a wake word any speech opens the stream, with the endpointer's usual lead in
+        if (speech)
+            OpenGatedStream(gateEndpointer.getSettings().paddingMs * targetSampleRate / 1000);
+
+        return;
+    }
+
+    bool fired;
+    {
+        LibGenisysStats::Timer timer(stats, LibGenisysStageWakeWord);
+        fired = keywordSpotter.processFrame(frame, frameSize);
+    }
+
+    if (fired)
+        OpenGatedStream(preRollCapacity);
+}
+
+void LibGenisysImpl::OpenGatedStream(int numPreRollSamples)
+{
+    if (CreateStream(ctx, &stream) != DS_ERR_OK)
+    {
+        stream = nullptr;
+        return;
+    }
+
+    //Oldest first, the pre-roll ends with the frame that opened the stream
+    const int capacity = (int)gatePreRoll.size();
+    const int numSamples = std::min(numPreRollSamples, gatePreRollSize);
+    const int start = (gatePreRollWrite - numSamples + capacity) % capacity;
+    const int firstPart = std::min(numSamples, capacity - start);
+
+    FeedStream(stream, gatePreRoll.data() + start, (unsigned int)firstPart);
+    if (numSamples > firstPart)
+        FeedStream(stream, gatePreRoll.data(), (unsigned int)(numSamples - firstPart));
+
+    gatePreRollSize = 0;
+    gateSilentFrames = 0;
+    gateUtteranceFrames = 0;
+}
+
+void LibGenisysImpl::FinishGatedUtterance()
+{
+    //DS_FinishStream releases the stream
+    char* transcript;
+    {
+        const auto decoding = model->lockForDecoding();
+        LibGenisysStats::Timer timer(stats, LibGenisysStageDecode);
+        transcript = DS_FinishStream(stream);
+    }
+    stream = nullptr;
+
+    const auto text = PostProcessTranscript(transcript);
+
+    keywordSpotter.reset();
+
+    if (wakeWordCallback && !text.empty())
+        wakeWordCallback(text.c_str(), wakeWordUserData);
+}
+
+int LibGenisysImpl::ResampleBlock(const float* buffer, int numSamples)
+{
+    {
+        LibGenisysStats::Timer timer(stats, LibGenisysStageResample);
+        float* channels[] = { const_cast<float*>(buffer) };
+        const juce::AudioSampleBuffer block(channels, 1, numSamples);
+        inputResampler->pushAudioBuffer(block);
+    }
+
+    return ReadResampled();
+}
+
+int LibGenisysImpl::FlushResampler()
+{
+    {
+        LibGenisysStats::Timer timer(stats, LibGenisysStageResample);
+        inputResampler->flush();
+    }
+
+    return ReadResampled();
+}
+
+int LibGenisysImpl::ReadResampled()
+{
+    const int numReady = std::min(inputResampler->samplesReady(), (int)nativeBuffer.size());
+    if (numReady <= 0)
+        return 0;
+
+    //Convert straight out of the resampler's FIFO storage
+    LibGenisysStats::Timer timer(stats, LibGenisysStageConversion);
+    const auto ready = inputResampler->prepareToRead(numReady);
+    const auto first = ready.first(0), second = ready.second(0);
+
+    juce::AudioDataConverters::convertFloatToInt16LE(first.data, nativeBuffer.data(), first.size);
+    juce::AudioDataConverters::convertFloatToInt16LE(second.data, nativeBuffer.data() + first.size, second.size);
+
+    inputResampler->finishedRead(ready.getNumSamples());
+    return ready.getNumSamples();
+}
+
+int LibGenisysImpl::ConvertToNative(const float* buffer, int numSamples)
+{
+    assert(numSamples <= (int)nativeBuffer.size());
+    LibGenisysStats::Timer timer(stats, LibGenisysStageConversion);
+    juce::AudioDataConverters::convertFloatToInt16LE(buffer, nativeBuffer.data(), numSamples);
+    return numSamples;
 }
 
 std::string LibGenisysImpl::processPath(std::string path)
@@ -108,14 +821,184 @@ std::string LibGenisysImpl::processNativePath(std::string path)
     return ProcessFile(ctx, path, true);
 }
 
+LibGenisysStatus LibGenisysImpl::processBatch(const char* const* paths,
+                                              int count,
+                                              int threads,
+                                              LibGenisysBatchCallback callback,
+                                              void* userData)
+{
+    if (!ctx)
+        return LibGenisysUninitialized;
+
+    if (count <= 0)
+        return LibGenisysStatusOk;
+
+    if (threads <= 0)
+        threads = std::max(1, (int)std::thread::hardware_concurrency());
+    threads = std::min(threads, count);
+
+    std::atomic<int> nextFile { 0 };
+    std::mutex callbackLock;
+
+    auto worker = [&]()
+    {
+        //Per worker, so endpointing needs no locking
+        Endpointer workerEndpointer;
+        std::vector<Endpointer::Segment> workerSegments;
+        std::string transcript;
+
+        for (int index = nextFile++; index < count; index = nextFile++)
+        {
+            LibGenisysBatchResult result = ProcessBatchFile(index, paths[index], workerEndpointer, workerSegments, transcript);
+
+            if (callback)
+            {
+                const std::lock_guard<std::mutex> lock(callbackLock);
+                callback(&result, userData);
+            }
+        }
+    };
+
+    std::vector<std::thread> workers;
+    workers.reserve(size_t(threads - 1));
+    for (int i = 1; i < threads; ++i)
+        workers.emplace_back(worker);
+
+    //The calling thread is the last worker
+    worker();
+
+    for (auto& t : workers)
+        t.join();
+
+    return LibGenisysStatusOk;
+}
+
+LibGenisysBatchResult LibGenisysImpl::ProcessBatchFile(int index,
+                                                       const char* path,
+                                                       Endpointer& fileEndpointer,
+                                                       std::vector<Endpointer::Segment>& segments,
+                                                       std::string& transcript)
+{
+    using Clock = std::chrono::steady_clock;
+
+    LibGenisysBatchResult result = {};
+    result.index = index;
+    result.path = path;
+    result.status = LibGenisysStatusOk;
+    transcript.clear();
+
+    const auto readStart = Clock::now();
+    ds_audio_buffer audio;
+    {
+        LibGenisysStats::Timer timer(stats, LibGenisysStageFileRead);
+        audio = GetAudioBuffer(path);
+    }
+    const auto readEnd = Clock::now();
+    result.readSeconds = std::chrono::duration<double>(readEnd - readStart).count();
+
+    if (!audio.samples)
+    {
+        result.status = LibGenisysFileError;
+        result.transcript = transcript.c_str();
+        return result;
+    }
+
+    const size_t numSamples = audio.numSamples;
+    result.audioSeconds = double(numSamples) / targetSampleRate;
+
+    const short* samples = audio.samples;
+
+    const bool cacheable = transcriptCache.isEnabled();
+    LibGenisysTranscriptCache::Key cacheKey;
+    if (cacheable)
+    {
+        cacheKey = TranscriptCacheKey(CacheSource::batch, samples, numSamples * sizeof(short));
+
+        if (transcriptCache.lookup(cacheKey, transcript))
+        {
+            result.cached = 1;
+            result.inferenceSeconds = std::chrono::duration<double>(Clock::now() - readEnd).count();
+            result.transcript = transcript.c_str();
+            return result;
+        }
+    }
+
+    segments.clear();
+    if (endpointing)
+    {
+        fileEndpointer.findSegments(samples, (int)numSamples, nullptr, 0, segments);
+    }
+    else
+    {
+        Endpointer::Segment whole;
+        whole.end = (int)numSamples;
+        segments.push_back(whole);
+    }
+
+    //One stream at a time per worker, fed and finished on this thread; the model is shared
+    for (const auto& segment : segments)
+    {
+        StreamingState* workerStream = nullptr;
+        if (CreateStream(ctx, &workerStream) != DS_ERR_OK)
+        {
+            result.status = LibGenisysInternalError;
+            break;
+        }
+
+        FeedStream(workerStream, samples + segment.start, (unsigned int)(segment.end - segment.start));
+
+        char* decoded;
+        {
+            const auto decoding = model->lockForDecoding();
+            LibGenisysStats::Timer timer(stats, LibGenisysStageDecode);
+            decoded = DS_FinishStream(workerStream);
+        }
+        auto text = PostProcessTranscript(decoded);
+
+        if (!text.empty())
+        {
+            if (!transcript.empty())
+                transcript += " ";
+            transcript += text;
+        }
+    }
+
+    if (cacheable && result.status == LibGenisysStatusOk)
+        CacheTranscript(cacheKey, transcript);
+
+    result.inferenceSeconds = std::chrono::duration<double>(Clock::now() - readEnd).count();
+    result.transcript = transcript.c_str();
+    return result;
+}
+
 ds_audio_buffer LibGenisysImpl::GetAudioBuffer(std::string path)
 {
-    ds_audio_buffer res = {0};
+    ds_audio_buffer res;
+
+    //Hand DeepSpeech the mapped PCM data directly, with no copy or extra pass over it
+    res.mapping = std::make_unique<WavIO::MappedReader>(path);
+    if (res.mapping->isOpen())
+    {
+        if (res.mapping->getHeader().numberOfChannels != 1)
+        {
+            std::cerr << "Number of channels in input file has to be 1, it is: "
+                      << res.mapping->getHeader().numberOfChannels << std::endl;
+        }
+
+        res.samples = res.mapping->getSamples16();
+        res.numSamples = res.mapping->getNumSamples16();
+
+        if (res.samples)
+            return res;
+    }
+    res.mapping.reset();
 
+    //Fall back to reading a copy, e.g. for stdin or misaligned data chunks
     auto inputFile = WavIO::Reader(path);
     if (!inputFile.isOpen())
     {
         std::cerr << "Could not open input file: " << path << std::endl;
+        return res;
     }
 
     auto inputHeader = inputFile.getHeader();
@@ -124,88 +1007,314 @@ ds_audio_buffer LibGenisysImpl::GetAudioBuffer(std::string path)
         std::cerr << "Number of channels in input file has to be 1, it is: " << inputHeader.numberOfChannels << std::endl;
     }
 
-    res.buffer_size = inputFile.getHeader().lengthInBytes;
-    res.buffer = (char*)malloc(sizeof(char) * res.buffer_size);
+    res.copy.resize(inputHeader.lengthInBytes / sizeof(short));
+    const int numBytesRead =
+        inputFile.readData(reinterpret_cast<unsigned char*>(res.copy.data()), (unsigned int)(res.copy.size() * sizeof(short)));
+    res.copy.resize(size_t(std::max(0, numBytesRead)) / sizeof(short));
 
-    inputFile.readData(reinterpret_cast<unsigned char*>(res.buffer), res.buffer_size);
+    res.samples = res.copy.data();
+    res.numSamples = res.copy.size();
     return res;
 }
 
-ds_audio_buffer LibGenisysImpl::DeNoiseAudioBuffer(ds_audio_buffer &input)
+std::string LibGenisysImpl::ProcessFile(ModelState* context, std::string path, bool show_times)
 {
-    if (!denoisingBuffer)
-        denoisingBuffer = std::make_unique<juce::AudioBuffer<float>>(1, input.buffer_size);
-    else
-        denoisingBuffer->setSize(1, input.buffer_size);
+    if (!context)
+        return "";
 
-    juce::AudioDataConverters::convertInt16LEToFloat(input.buffer, denoisingBuffer->getWritePointer(0), input.buffer_size);
-    //for (int i = 0; i < input.buffer_size; i++)
-    //{
-    //    denoisingBuffer->getWritePointer(0)[i] = input.buffer[i] * 32768.0f;
-    //}
+    //Hashed from a mapping of the file, a pass over memory that is far cheaper than inference
+    bool cacheable = false;
+    LibGenisysTranscriptCache::Key cacheKey;
+    if (transcriptCache.isEnabled())
+    {
+        WavIO::MappedReader mapping(path);
+        if (mapping.isOpen())
+        {
+            cacheable = true;
+            cacheKey = TranscriptCacheKey(CacheSource::file, mapping.getData(), mapping.getDataSize());
 
-    rnnoise_process_frame(st, denoisingBuffer->getWritePointer(0), denoisingBuffer->getReadPointer(0));
-    
-    juce::AudioDataConverters::convertFloatToInt16LE(denoisingBuffer->getReadPointer(0), input.buffer, input.buffer_size);
-    //for (int i = 0; i < input.buffer_size; i++)
-    //{
-    //    input.buffer[i] = juce::jmax<float>(-32768, juce::jmin<float>(32767, denoisingBuffer->getReadPointer(0)[i])) * (1.0f / 32768.0f);
-    //}
+            std::string cached;
+            if (transcriptCache.lookup(cacheKey, cached))
+            {
+                if (!cached.empty())
+                    printf("%s\n", cached.c_str());
+                return cached;
+            }
+        }
+    }
 
-    return input;
-}
+    //Pulled from disk in blocks of whole endpointer frames, so memory doesn't grow with the file
+    WavIO::ChunkReader reader(path, size_t(endpointer.getFrameSize() * framesPerFileChunk));
+    if (!reader.isOpen())
+    {
+        std::cerr << "Could not open input file: " << path << std::endl;
+        return "";
+    }
 
-std::string LibGenisysImpl::ProcessFile(ModelState* context, std::string path, bool show_times)
-{
-    ds_audio_buffer audio = GetAudioBuffer(path);
+    if (reader.getHeader().numberOfChannels != 1)
+    {
+        std::cerr << "Number of channels in input file has to be 1, it is: " << reader.getHeader().numberOfChannels << std::endl;
+    }
+
+    //Files are already at 16kHz, RNNoise only runs on 48kHz input ahead of the resampler
+    const uint64_t startTime = LibGenisysStats::threadCpuNanoseconds();
 
-    //DeNoiseAudioBuffer(audio);
+    auto readChunk = [this, &reader]()
+    {
+        LibGenisysStats::Timer timer(stats, LibGenisysStageFileRead);
+        return reader.readChunk();
+    };
 
-    // Pass audio to DeepSpeech
-    // We take half of buffer_size because buffer is a char* while
-    // LocalDsSTT() expected a short*
-    ds_result result = LocalDsSTT(context,
-                                  (const short*)audio.buffer,
-                                  audio.buffer_size / 2,
-                                  extended_metadata,
-                                  json_output);
-    free(audio.buffer);
+    std::string ret;
+    StreamingState* fileStream = nullptr;
 
-    if (result.string)
+    auto appendText = [&ret](const std::string& text)
     {
-        printf("%s\n", result.string);
-        auto ret = std::string(result.string);
+        if (text.empty())
+            return;
 
-        //TODO: WIP: Optimize string massaging
-        ret = std::regex_replace(ret, std::regex("^ +| +$|( ) +"), "$1");
+        if (!ret.empty())
+            ret += " ";
+        ret += text;
+    };
 
-        DS_FreeString((char*)result.string);
-        return std::string(ret);
+    if (!endpointing)
+    {
+        if (CreateStream(context, &fileStream) != DS_ERR_OK)
+            return "";
+
+        for (size_t numRead; (numRead = readChunk()) > 0;)
+            FeedStream(fileStream, reader.getChunk(), (unsigned int)numRead);
+
+        appendText(FinishFileStream(fileStream));
+    }
+    else
+    {
+        //Frame by frame version of Endpointer::findSegments, each segment gets a stream of its own
+        const auto& settings = endpointer.getSettings();
+        const int frameSize = endpointer.getFrameSize();
+        const int splitPauseFrames = std::max(1, settings.splitPauseMs / settings.frameMs);
+        const int minSpeechFrames = std::max(1, settings.minSpeechMs / settings.frameMs);
+
+        //The last paddingMs of audio, fed ahead of each segment
+        std::vector<short> preRoll(size_t(std::max(1, settings.paddingMs * settings.sampleRate / 1000)));
+        size_t preRollPosition = 0, preRollFill = 0;
+
+        int numSpeechFrames = 0, numSilentFrames = 0;
+        bool seededNoiseFloor = false;
+        endpointer.reset();
+
+        auto closeSegment = [&]()
+        {
+            if (numSpeechFrames >= minSpeechFrames)
+                appendText(FinishFileStream(fileStream));
+            else
+                DS_FreeStream(fileStream);
+
+            fileStream = nullptr;
+        };
+
+        for (size_t numRead; (numRead = readChunk()) > 0;)
+        {
+            const short* chunk = reader.getChunk();
+
+            //The first chunk is the look-ahead, seeded like findSegments seeds from the whole signal
+            if (!seededNoiseFloor)
+            {
+                endpointer.seedNoiseFloor(chunk, (int)numRead);
+                seededNoiseFloor = true;
+            }
+
+            for (size_t offset = 0; offset < numRead; offset += size_t(frameSize))
+            {
+                const short* frame = chunk + offset;
+                const int frameLength = (int)std::min(size_t(frameSize), numRead - offset);
+                const bool speech = endpointer.isSpeechFrame(frame, frameLength);
+
+                if (!fileStream && speech)
+                {
+                    if (CreateStream(context, &fileStream) != DS_ERR_OK)
+                    {
+                        fileStream = nullptr;
+                        return ret;
+                    }
+
+                    //Oldest samples first
+                    if (preRollFill == preRoll.size())
+                        FeedStream(fileStream, preRoll.data() + preRollPosition, (unsigned int)(preRoll.size() - preRollPosition));
+                    FeedStream(fileStream, preRoll.data(), (unsigned int)preRollPosition);
+
+                    numSpeechFrames = 0;
+                    numSilentFrames = 0;
+                }
+
+                if (fileStream)
+                {
+                    FeedStream(fileStream, frame, (unsigned int)frameLength);
+
+                    if (speech)
+                    {
+                        ++numSpeechFrames;
+                        numSilentFrames = 0;
+                    }
+                    else if (++numSilentFrames > splitPauseFrames)
+                    {
+                        closeSegment();
+                    }
+                }
+
+                for (int i = 0; i < frameLength; ++i)
+                {
+                    preRoll[preRollPosition] = frame[i];
+                    preRollPosition = preRollPosition + 1 == preRoll.size() ? 0 : preRollPosition + 1;
+                }
+                preRollFill = std::min(preRoll.size(), preRollFill + size_t(frameLength));
+            }
+        }
+
+        if (fileStream)
+            closeSegment();
+    }
+
+    double cpu_time_overall = double(LibGenisysStats::threadCpuNanoseconds() - startTime) * 1.0e-9;
+
+    if (cacheable)
+        CacheTranscript(cacheKey, ret);
+
+    if (!ret.empty())
+    {
+        printf("%s\n", ret.c_str());
+        return ret;
     }
 
     if (show_times) {
         printf("cpu_time_overall=%.05f\n",
-               result.cpu_time_overall);
+               cpu_time_overall);
     }
 
     return "";
 }
 
+std::string LibGenisysImpl::FinishFileStream(StreamingState* fileStream)
+{
+    char* text;
+
+    //DS_FinishStream* release the stream
+    {
+        const auto decoding = model->lockForDecoding();
+        LibGenisysStats::Timer timer(stats, LibGenisysStageDecode);
+
+        if (extended_metadata || json_output)
+        {
+            Metadata* result = DS_FinishStreamWithMetadata(fileStream, extended_metadata ? 1 : json_candidate_transcripts);
+            text = extended_metadata ? CandidateTranscriptToString(&result->transcripts[0]) : MetadataToJSON(result);
+            DS_FreeMetadata(result);
+        }
+        else
+        {
+            text = DS_FinishStream(fileStream);
+        }
+    }
+
+    return PostProcessTranscript(text);
+}
+
+std::string LibGenisysImpl::ProcessNativeSamples(ModelState* context,
+                                                 const short* buffer,
+                                                 size_t numSamples,
+                                                 const float* voiceProbabilities,
+                                                 int numProbabilities,
+                                                 double* cpuTime)
+{
+    if (!context || !buffer || numSamples == 0)
+        return "";
+
+    if (!transcriptCache.isEnabled())
+        return TranscribeSamples(context, buffer, numSamples, voiceProbabilities, numProbabilities, cpuTime);
+
+    const auto cacheKey =
+        TranscriptCacheKey(CacheSource::samples, buffer, numSamples * sizeof(short), voiceProbabilities, numProbabilities);
+
+    std::string transcript;
+    if (transcriptCache.lookup(cacheKey, transcript))
+        return transcript;
+
+    transcript = TranscribeSamples(context, buffer, numSamples, voiceProbabilities, numProbabilities, cpuTime);
+    CacheTranscript(cacheKey, transcript);
+    return transcript;
+}
+
+std::string LibGenisysImpl::TranscribeSamples(ModelState* context,
+                                              const short* buffer,
+                                              size_t numSamples,
+                                              const float* voiceProbabilities,
+                                              int numProbabilities,
+                                              double* cpuTime)
+{
+    if (!endpointing)
+        return TranscribeSpan(context, buffer, numSamples, cpuTime);
+
+    //Silence never reaches the acoustic model, and long recordings are split at pauses
+    endpointer.findSegments(buffer, (int)numSamples, voiceProbabilities, numProbabilities, speechSegments);
+
+    std::string transcript;
+    for (const auto& segment : speechSegments)
+    {
+        auto text = TranscribeSpan(context, buffer + segment.start, size_t(segment.end - segment.start), cpuTime);
+
+        if (!text.empty())
+        {
+            if (!transcript.empty())
+                transcript += " ";
+            transcript += text;
+        }
+    }
+
+    return transcript;
+}
+
+std::string LibGenisysImpl::TranscribeSpan(ModelState* context, const short* buffer, size_t numSamples, double* cpuTime)
+{
+    ds_result result = LocalDsSTT(context, buffer, numSamples, extended_metadata, json_output);
+
+    if (cpuTime)
+        *cpuTime += result.cpu_time_overall;
+
+    return PostProcessTranscript((char*)result.string);
+}
+
+std::string LibGenisysImpl::PostProcessTranscript(char* transcript)
+{
+    if (!transcript)
+        return "";
+
+    LibGenisysStats::Timer timer(stats, LibGenisysStagePostProcess);
+    auto ret = std::string(transcript);
+    DS_FreeString(transcript);
+
+    //TODO: WIP: Optimize string massaging
+    return std::regex_replace(ret, std::regex("^ +| +$|( ) +"), "$1");
+}
+
 ds_result LibGenisysImpl::LocalDsSTT(ModelState* aCtx, const short* aBuffer, size_t aBufferSize, bool extended_output, bool json_output)
 {
     ds_result res = {0};
 
-    clock_t ds_start_time = clock();
+    const uint64_t ds_start_time = LibGenisysStats::threadCpuNanoseconds();
 
     // sphinx-doc: c_ref_inference_start
     if (extended_output)
     {
+        const auto decoding = model->lockForDecoding();
+        LibGenisysStats::Timer timer(stats, LibGenisysStageDecode);
         Metadata *result = DS_SpeechToTextWithMetadata(aCtx, aBuffer, (unsigned int)aBufferSize, 1);
         res.string = CandidateTranscriptToString(&result->transcripts[0]);
         DS_FreeMetadata(result);
     }
     else if (json_output)
     {
+        const auto decoding = model->lockForDecoding();
+        LibGenisysStats::Timer timer(stats, LibGenisysStageDecode);
         Metadata *result = DS_SpeechToTextWithMetadata(aCtx, aBuffer, (unsigned int)aBufferSize, json_candidate_transcripts);
         res.string = MetadataToJSON(result);
         DS_FreeMetadata(result);
@@ -213,7 +1322,7 @@ ds_result LibGenisysImpl::LocalDsSTT(ModelState* aCtx, const short* aBuffer, siz
     else if (stream_size > 0)
     {
         StreamingState* ctx;
-        int status = DS_CreateStream(aCtx, &ctx);
+        int status = CreateStream(aCtx, &ctx);
 
         if (status != DS_ERR_OK)
         {
@@ -228,10 +1337,15 @@ ds_result LibGenisysImpl::LocalDsSTT(ModelState* aCtx, const short* aBuffer, siz
         while (off < aBufferSize)
         {
             size_t cur = aBufferSize - off > stream_size ? stream_size : aBufferSize - off;
-            DS_FeedAudioContent(ctx, aBuffer + off, (unsigned int)cur);
+            FeedStream(ctx, aBuffer + off, (unsigned int)cur);
             off += cur;
             prev = last;
-            const char* partial = DS_IntermediateDecode(ctx);
+            const char* partial;
+            {
+                const auto decoding = model->lockForDecoding();
+                LibGenisysStats::Timer timer(stats, LibGenisysStageDecode);
+                partial = DS_IntermediateDecode(ctx);
+            }
 
             if (last == nullptr || strcmp(last, partial))
             {
@@ -254,12 +1368,14 @@ ds_result LibGenisysImpl::LocalDsSTT(ModelState* aCtx, const short* aBuffer, siz
             DS_FreeString((char *) last);
         }
 
+        const auto decoding = model->lockForDecoding();
+        LibGenisysStats::Timer timer(stats, LibGenisysStageDecode);
         res.string = DS_FinishStream(ctx);
     }
     else if (extended_stream_size > 0)
     {
         StreamingState* ctx;
-        int status = DS_CreateStream(aCtx, &ctx);
+        int status = CreateStream(aCtx, &ctx);
 
         if (status != DS_ERR_OK)
         {
@@ -274,10 +1390,15 @@ ds_result LibGenisysImpl::LocalDsSTT(ModelState* aCtx, const short* aBuffer, siz
         while (off < aBufferSize)
         {
             size_t cur = aBufferSize - off > extended_stream_size ? extended_stream_size : aBufferSize - off;
-            DS_FeedAudioContent(ctx, aBuffer + off, (unsigned int)cur);
+            FeedStream(ctx, aBuffer + off, (unsigned int)cur);
             off += cur;
             prev = last;
-            const Metadata* result = DS_IntermediateDecodeWithMetadata(ctx, 1);
+            const Metadata* result;
+            {
+                const auto decoding = model->lockForDecoding();
+                LibGenisysStats::Timer timer(stats, LibGenisysStageDecode);
+                result = DS_IntermediateDecodeWithMetadata(ctx, 1);
+            }
             const char* partial = CandidateTranscriptToString(&result->transcripts[0]);
 
             if (last == nullptr || strcmp(last, partial))
@@ -297,6 +1418,8 @@ ds_result LibGenisysImpl::LocalDsSTT(ModelState* aCtx, const short* aBuffer, siz
             DS_FreeMetadata((Metadata *)result);
         }
 
+        const auto decoding = model->lockForDecoding();
+        LibGenisysStats::Timer timer(stats, LibGenisysStageDecode);
         const Metadata* result = DS_FinishStreamWithMetadata(ctx, 1);
         res.string = CandidateTranscriptToString(&result->transcripts[0]);
         DS_FreeMetadata((Metadata *)result);
@@ -304,12 +1427,14 @@ ds_result LibGenisysImpl::LocalDsSTT(ModelState* aCtx, const short* aBuffer, siz
     }
     else
     {
+        //Feeds and decodes in one call, so it all counts as decode
+        const auto decoding = model->lockForDecoding();
+        LibGenisysStats::Timer timer(stats, LibGenisysStageDecode);
         res.string = DS_SpeechToText(aCtx, aBuffer, (unsigned int)aBufferSize);
     }
     // sphinx-doc: c_ref_inference_stop
-    clock_t ds_end_infer = clock();
 
-    res.cpu_time_overall = ((double) (ds_end_infer - ds_start_time)) / CLOCKS_PER_SEC;
+    res.cpu_time_overall = double(LibGenisysStats::threadCpuNanoseconds() - ds_start_time) * 1.0e-9;
 
     return res;
 }
@@ -431,21 +1556,3 @@ char* LibGenisysImpl::MetadataToJSON(Metadata* result)
 
     return strdup(out_string.str().c_str());
 }
-
-std::vector<std::string> LibGenisysImpl::SplitStringOnDelim(std::string in_string, std::string delim)
-{
-    std::vector<std::string> out_vector;
-    char * tmp_str = new char[in_string.size() + 1];
-    std::copy(in_string.begin(), in_string.end(), tmp_str);
-    tmp_str[in_string.size()] = '\0';
-    const char* token = strtok(tmp_str, delim.c_str());
-
-    while( token != NULL )
-    {
-        out_vector.push_back(token);
-        token = strtok(NULL, delim.c_str());
-    }
-
-    delete[] tmp_str;
-    return out_vector;
-}
\ No newline at end of file
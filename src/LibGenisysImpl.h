@@ -1,17 +1,33 @@
 #pragma once
 
 #include "deepspeech.h"
-#include "rnnoise.h"
 #include "wavio.h"
 
+#include "genisys/genisys_endpointer.h"
+#include "genisys/genisys_keywordspotter.h"
+#include "genisys/genisys_levelmeter.h"
+#include "genisys/genisys_spscfifo.h"
 #include "gin/gin_resamplingfifo.h"
 #include "LibGenisysAPI.h"
+#include "LibGenisysDenoiser.h"
+#include "LibGenisysModel.h"
+#include "LibGenisysStats.h"
+#include "LibGenisysTranscriptCache.h"
 
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <iostream>
+#include <limits>
+#include <memory>
+#include <mutex>
 #include <regex>
+#include <thread>
 #include <sstream>
 #include <string>
+#include <vector>
 
 typedef struct {
     const char* string;
@@ -24,10 +40,13 @@ struct meta_word {
     float duration;
 };
 
-typedef struct {
-    char*  buffer;
-    size_t buffer_size;
-} ds_audio_buffer;
+//16-bit samples of a WAV file, used in place from a memory mapping when the file allows it
+struct ds_audio_buffer {
+    std::unique_ptr<WavIO::MappedReader> mapping;
+    std::vector<short> copy;
+    const short* samples = nullptr;
+    size_t numSamples = 0;
+};
 
 class LibGenisysImpl
 {
@@ -39,26 +58,164 @@ public:
     std::string processNativeFloat(float* buffer, int numSamples);
     std::string processPath(std::string path);
     std::string processNativePath(std::string path);
+    LibGenisysStatus processBatch(const char* const* paths,
+                                  int count,
+                                  int threads,
+                                  LibGenisysBatchCallback callback,
+                                  void* userData);
+
+    LibGenisysStatus openStream();
+    LibGenisysStatus feedFloat(const float* buffer, int numSamples);
+    LibGenisysStatus feedNativeFloat(const float* buffer, int numSamples);
+    std::string intermediateDecode();
+    std::string finishStream();
+    void cancelStream();
+
+    LibGenisysStatus startListening();
+    LibGenisysStatus pushFloat(const float* buffer, int numSamples);
+    std::string stopListening();
+
+    LibGenisysStatus addWakeWord(const float* buffer, int numSamples);
+    void clearWakeWords();
+    LibGenisysStatus startWakeWordListening(LibGenisysTranscriptCallback callback, void* userData);
+
+    LibGenisysStatus setHotWords(const char* hotWordList);
+    LibGenisysStatus clearHotWords();
+    LibGenisysStatus setScorerAlphaBeta(float alpha, float beta);
+
+    LibGenisysStatus setDenoising(bool shouldDenoise);
+
+    LibGenisysStatus setTranscriptCache(unsigned int maxEntries, unsigned long long maxBytes);
+    void clearTranscriptCache();
+    LibGenisysStatus getTranscriptCacheStats(LibGenisysCacheStats* out) const;
+
+    LibGenisysStatus getStats(LibGenisysStageStats* out, int maxStages) const;
+    void resetStats();
+
+    LibGenisysStatus getInputLevels(LibGenisysInputLevels* out) const;
 private:
+    //Per-stage timings, recorded lock-free from whichever thread runs the stage
+    LibGenisysStats stats;
+    void FeedStream(StreamingState* target, const short* buffer, unsigned int numSamples);
+    int CreateStream(ModelState* context, StreamingState** target);
+
     //Resampler
     std::unique_ptr<ResamplingFifo> inputResampler;
     const int targetSampleRate = 16000;
     const int maxInputSampleRate = 96000;
-    int currentInputSampleRate;
-    int currentBlockSize;
-
-    //DeepSpeech State Variable
-    ModelState* ctx;
-
-    //RNNoise State Variable
-    DenoiseState *st;
+    int currentInputSampleRate = 0;
+    int currentBlockSize = 0;
+
+    //16kHz DeepSpeech feed, filled straight from the resampler's FIFO storage
+    std::vector<short> nativeBuffer;
+    int ResampleBlock(const float* buffer, int numSamples);
+    int FlushResampler();
+    int ReadResampled();
+    int ConvertToNative(const float* buffer, int numSamples);
+
+    //DeepSpeech State Variables, the model is shared with every other instance using it
+    std::shared_ptr<LibGenisysModel> model;
+    ModelState* ctx = nullptr;
+
+    //Streaming session, fed block by block as audio arrives
+    StreamingState* stream = nullptr;
+    void FeedResampled(const float* buffer, int numSamples);
+    std::string FinishStream();
+
+    //Live input, the audio thread copies into the ring and the worker feeds the stream from it
+    //The worker holds liveLock while it feeds, so intermediateDecode can share the stream
+    const double liveRingSeconds = 2.0;
+    const std::chrono::milliseconds livePollInterval { 5 };
+    SpscFifo liveFifo { 1 };
+    std::vector<float> liveRing;
+    std::atomic<bool> listening { false };
+    std::atomic<int> pushesInFlight { 0 };
+    std::thread liveWorker;
+    std::mutex liveLock;
+    std::condition_variable liveWakeup;
+    bool liveStopRequested = false;
+    bool IsListening() const { return liveWorker.joinable(); }
+    void StartLiveWorker();
+    void LiveWorkerLoop();
+    void DrainLiveRing();
+    void StopLiveWorker();
+    void WaitForPushes();
+
+    //Wake word gating, the live input only reaches DeepSpeech from the wake word to the next pause
+    //The pre-roll holds the 16kHz audio the spotter has seen, so the stream still hears the wake word
+    const int wakeWordPreRollMs = 2000;
+    const int maxUtteranceMs = 10000;
+    bool wakeWordGating = false;
+    KeywordSpotter keywordSpotter;
+    Endpointer gateEndpointer;
+    std::vector<short> gatePreRoll;
+    int gatePreRollWrite = 0;
+    int gatePreRollSize = 0;
+    std::vector<short> gateFrame;
+    int gateFrameFill = 0;
+    int gateSilentFrames = 0;
+    int gateUtteranceFrames = 0;
+    LibGenisysTranscriptCallback wakeWordCallback = nullptr;
+    void* wakeWordUserData = nullptr;
+    void GateNative(const short* buffer, int numSamples);
+    void GateFrame(const short* frame, int frameSize);
+    void OpenGatedStream(int numPreRollSamples);
+    void FinishGatedUtterance();
+
+    //RNNoise stage, runs on 48kHz input ahead of the resampler
+    //Also used for its voice probabilities when only endpointing is enabled
+    bool denoising = false;
+    LibGenisysDenoiser denoiser;
+    juce::AudioBuffer<float> denoisedBuffer;
+    bool UsesDenoiser() const;
+    const float* DenoiseBlock(const float* buffer, int numSamples);
+
+    //Levels of the stream input as it arrives, published for readers on any thread
+    //Only one thread feeds at a time: the caller, or the live worker while listening
+    InputLevelMeter inputMeter;
+    void MeterInput(const float* buffer, int numSamples, int sampleRate);
+
+    //Voice activity endpointing, trims silence and splits at pauses before inference
+    bool endpointing = true;
+    Endpointer endpointer;
+    std::vector<Endpointer::Segment> speechSegments;
+
+    //Final transcripts by audio content, looked up ahead of one-shot inference
+    //Each entry point segments and decodes its own way, so they don't share entries
+    enum class CacheSource { samples, file, batch };
+    LibGenisysTranscriptCache transcriptCache;
+    LibGenisysTranscriptCache::Key TranscriptCacheKey(CacheSource source,
+                                                      const void* pcm,
+                                                      size_t numBytes,
+                                                      const float* voiceProbabilities = nullptr,
+                                                      int numProbabilities = 0) const;
+    void CacheTranscript(const LibGenisysTranscriptCache::Key& key, const std::string& transcript);
 
     ds_audio_buffer GetAudioBuffer(std::string path);
 
-    ds_audio_buffer DeNoiseAudioBuffer(ds_audio_buffer& input);
-    std::unique_ptr<juce::AudioBuffer<float>> denoisingBuffer;
-
+    //Native files are streamed to DeepSpeech in chunks of this many endpointer frames (1s at 16kHz)
+    const int framesPerFileChunk = 100;
     std::string ProcessFile(ModelState* context, std::string path, bool show_times);
+    std::string FinishFileStream(StreamingState* fileStream);
+    std::string ProcessNativeSamples(ModelState* context,
+                                     const short* buffer,
+                                     size_t numSamples,
+                                     const float* voiceProbabilities = nullptr,
+                                     int numProbabilities = 0,
+                                     double* cpuTime = nullptr);
+    std::string TranscribeSamples(ModelState* context,
+                                  const short* buffer,
+                                  size_t numSamples,
+                                  const float* voiceProbabilities,
+                                  int numProbabilities,
+                                  double* cpuTime);
+    std::string TranscribeSpan(ModelState* context, const short* buffer, size_t numSamples, double* cpuTime);
+    LibGenisysBatchResult ProcessBatchFile(int index,
+                                           const char* path,
+                                           Endpointer& fileEndpointer,
+                                           std::vector<Endpointer::Segment>& segments,
+                                           std::string& transcript);
+    std::string PostProcessTranscript(char* transcript);
     ds_result LocalDsSTT(ModelState* aCtx, const short* aBuffer, size_t aBufferSize, bool extended_output, bool json_output);
 
     const char* hot_words = "genesis:5,open:3,close:3,pro:3,tools:5,logic:3,live:3";
@@ -79,6 +236,5 @@ private:
     std::vector<meta_word> CandidateTranscriptToWords(const CandidateTranscript* transcript);
     std::string CandidateTranscriptToJSON(const CandidateTranscript *transcript);
     char* MetadataToJSON(Metadata* result);
-    std::vector<std::string> SplitStringOnDelim(std::string in_string, std::string delim);
 };
 
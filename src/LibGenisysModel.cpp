@@ -0,0 +1,241 @@
+#include "LibGenisysModel.h"
+#include "LibGenisysTranscriptCache.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+
+std::mutex LibGenisysModel::registryLock;
+std::map<LibGenisysModel::Key, std::weak_ptr<LibGenisysModel>> LibGenisysModel::registry;
+
+LibGenisysModel::LibGenisysModel(std::string modelPath_, std::string scorerPath_)
+    : modelPath(std::move(modelPath_)), scorerPath(std::move(scorerPath_))
+{
+}
+
+LibGenisysModel::~LibGenisysModel()
+{
+    if (ctx)
+        DS_FreeModel(ctx);
+}
+
+std::shared_ptr<LibGenisysModel> LibGenisysModel::acquire(const std::string& modelPath,
+                                                          const std::string& scorerPath,
+                                                          const char* hotWords)
+{
+    // Held across the load so concurrent callers wait for one load instead of racing two
+    const std::lock_guard<std::mutex> lock(registryLock);
+
+    const Key key(modelPath, scorerPath);
+    auto it = registry.find(key);
+    if (it != registry.end())
+    {
+        if (auto existing = it->second.lock())
+            return existing;
+
+        registry.erase(it);
+    }
+
+    std::shared_ptr<LibGenisysModel> model(new LibGenisysModel(modelPath, scorerPath));
+    if (!model->load(hotWords))
+        return nullptr;
+
+    model->UpdateConfigurationHash();
+
+    registry[key] = model;
+    return model;
+}
+
+bool LibGenisysModel::load(const char* hotWords)
+{
+    int status = DS_CreateModel(modelPath.c_str(), &ctx);
+    if (status != 0)
+    {
+        std::cerr << "Could not load DeepSpeech model: " << modelPath << std::endl;
+        ctx = nullptr;
+        return false;
+    }
+
+    if (scorerPath.empty())
+        return true;
+
+    status = DS_EnableExternalScorer(ctx, scorerPath.c_str());
+    if (status != 0)
+    {
+        //The acoustic model is still usable without the scorer
+        std::cerr << "Could not enable external scorer: " << scorerPath << std::endl;
+        return true;
+    }
+
+    scorerEnabled = true;
+
+    HotWords words;
+    if (!ParseHotWords(hotWords, words))
+        std::cerr << "Ignoring malformed hot words: " << hotWords << std::endl;
+    else if (ApplyHotWords(words) != LibGenisysStatusOk)
+        std::cerr << "Could not add hot words: " << hotWords << std::endl;
+
+    return true;
+}
+
+LibGenisysStatus LibGenisysModel::setHotWords(const char* hotWordList)
+{
+    if (!ctx)
+        return LibGenisysUninitialized;
+
+    //Parsed up front so a bad list leaves the current hot words alone
+    HotWords words;
+    if (!ParseHotWords(hotWordList, words))
+        return LibGenisysInvalidArgument;
+
+    const std::unique_lock<std::shared_timed_mutex> lock(decodingLock);
+    const auto status = ApplyHotWords(words);
+    UpdateConfigurationHash();
+    return status;
+}
+
+LibGenisysStatus LibGenisysModel::clearHotWords()
+{
+    if (!ctx)
+        return LibGenisysUninitialized;
+
+    if (!scorerEnabled)
+        return LibGenisysScorerUnavailable;
+
+    const std::unique_lock<std::shared_timed_mutex> lock(decodingLock);
+
+    if (DS_ClearHotWords(ctx) != DS_ERR_OK)
+        return LibGenisysInternalError;
+
+    currentHotWords.clear();
+    UpdateConfigurationHash();
+    return LibGenisysStatusOk;
+}
+
+LibGenisysStatus LibGenisysModel::setScorerAlphaBeta(float alpha, float beta)
+{
+    if (!ctx)
+        return LibGenisysUninitialized;
+
+    if (!scorerEnabled)
+        return LibGenisysScorerUnavailable;
+
+    if (!std::isfinite(alpha) || !std::isfinite(beta))
+        return LibGenisysInvalidArgument;
+
+    const std::unique_lock<std::shared_timed_mutex> lock(decodingLock);
+
+    if (DS_SetScorerAlphaBeta(ctx, alpha, beta) != DS_ERR_OK)
+        return LibGenisysInternalError;
+
+    scorerWeightsSet = true;
+    scorerAlpha = alpha;
+    scorerBeta = beta;
+    UpdateConfigurationHash();
+    return LibGenisysStatusOk;
+}
+
+LibGenisysStatus LibGenisysModel::ApplyHotWords(const HotWords& words)
+{
+    if (!scorerEnabled)
+        return words.empty() ? LibGenisysStatusOk : LibGenisysScorerUnavailable;
+
+    //Only the words that change are touched, DeepSpeech will not overwrite an existing boost
+    for (auto it = currentHotWords.begin(); it != currentHotWords.end();)
+    {
+        const auto replacement = words.find(it->first);
+        if (replacement != words.end() && replacement->second == it->second)
+        {
+            ++it;
+            continue;
+        }
+
+        if (DS_EraseHotWord(ctx, it->first.c_str()) != DS_ERR_OK)
+            return LibGenisysInternalError;
+
+        it = currentHotWords.erase(it);
+    }
+
+    for (const auto& word : words)
+    {
+        if (currentHotWords.count(word.first) != 0)
+            continue;
+
+        if (DS_AddHotWord(ctx, word.first.c_str(), word.second) != DS_ERR_OK)
+            return LibGenisysInternalError;
+
+        currentHotWords.insert(word);
+    }
+
+    return LibGenisysStatusOk;
+}
+
+void LibGenisysModel::UpdateConfigurationHash()
+{
+    std::string description = modelPath + '\0' + scorerPath + '\0' + (scorerEnabled ? '1' : '0');
+
+    //Boosts and weights go in bit for bit
+    auto appendFloat = [&description](float value) { description.append(reinterpret_cast<const char*>(&value), sizeof(value)); };
+
+    for (const auto& word : currentHotWords)
+    {
+        description += word.first + '\0';
+        appendFloat(word.second);
+    }
+
+    if (scorerWeightsSet)
+    {
+        appendFloat(scorerAlpha);
+        appendFloat(scorerBeta);
+    }
+
+    configurationHash.store(LibGenisysTranscriptCache::hash(description.data(), description.size()),
+                            std::memory_order_release);
+}
+
+bool LibGenisysModel::ParseHotWords(const char* text, HotWords& words)
+{
+    words.clear();
+
+    if (!text)
+        return true;
+
+    const std::string list(text);
+    const char* whitespace = " \t\r\n";
+
+    for (size_t start = 0; start <= list.size();)
+    {
+        size_t end = list.find(',', start);
+        if (end == std::string::npos)
+            end = list.size();
+
+        const std::string entry = list.substr(start, end - start);
+        start = end + 1;
+
+        const size_t first = entry.find_first_not_of(whitespace);
+        if (first == std::string::npos)
+            continue;
+
+        const size_t colon = entry.rfind(':');
+        if (colon == std::string::npos || colon < first)
+            return false;
+
+        const size_t wordEnd = entry.find_last_not_of(whitespace, colon - 1);
+        if (colon == first || wordEnd == std::string::npos || wordEnd < first)
+            return false;
+
+        //strtof reads "3x" as 3 and "x" as 0, so the whole boost has to be consumed
+        const std::string boostText = entry.substr(colon + 1);
+        const char* boostStart = boostText.c_str();
+        char* boostEnd = nullptr;
+        const float boost = std::strtof(boostStart, &boostEnd);
+
+        if (boostEnd == boostStart || !std::isfinite(boost)
+            || boostText.find_first_not_of(whitespace, size_t(boostEnd - boostStart)) != std::string::npos)
+            return false;
+
+        words[entry.substr(first, wordEnd - first + 1)] = boost;
+    }
+
+    return true;
+}
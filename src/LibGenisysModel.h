@@ -0,0 +1,103 @@
+#pragma once
+
+#include "deepspeech.h"
+#include "LibGenisysAPI.h"
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * A DeepSpeech model, its external scorer and hot words, loaded once per process
+ *
+ * Instances are handed out by acquire() and shared between every LibGenisysImpl
+ * that asks for the same model and scorer paths. The ModelState is freed when the
+ * last instance holding it goes away. Streams are per instance, the model is not.
+ *
+ * Hot words and scorer weights can be changed while the model is in use. Every
+ * DeepSpeech call that creates a stream or decodes holds lockForDecoding(), and
+ * changes wait for those calls to return. A stream keeps the hot words it was
+ * created with, scorer weights apply from its next decode.
+ */
+class LibGenisysModel
+{
+public:
+    ~LibGenisysModel();
+
+    /**
+     * Returns the shared model for the given paths, loading it if no instance holds it yet.
+     *
+     * @param modelPath path to the .pbmm/.tflite acoustic model
+     * @param scorerPath path to the external scorer, or an empty string for none
+     * @param hotWords comma separated word:boost pairs applied when the model is first loaded
+     *
+     * @returns the shared model, or nullptr if the acoustic model could not be loaded
+     */
+    static std::shared_ptr<LibGenisysModel> acquire(const std::string& modelPath,
+                                                    const std::string& scorerPath,
+                                                    const char* hotWords);
+
+    ModelState* get() const noexcept { return ctx; }
+
+    /** Held around DeepSpeech calls that create a stream or decode, so changes never land mid-call */
+    std::shared_lock<std::shared_timed_mutex> lockForDecoding() const
+    {
+        return std::shared_lock<std::shared_timed_mutex>(decodingLock);
+    }
+
+    /**
+     * Replaces the hot words of the model
+     *
+     * @param hotWordList comma separated word:boost pairs, or an empty string for none
+     *
+     * @returns the result status, LibGenisysInvalidArgument if the list is malformed,
+     *          in which case the current hot words are kept
+     */
+    LibGenisysStatus setHotWords(const char* hotWordList);
+
+    /** Removes every hot word from the model */
+    LibGenisysStatus clearHotWords();
+
+    /** Sets the language model weight and word insertion bonus of the scorer */
+    LibGenisysStatus setScorerAlphaBeta(float alpha, float beta);
+
+    /** Hash of the paths, hot words and scorer weights, for keying cached transcripts */
+    uint64_t getConfigurationHash() const noexcept { return configurationHash.load(std::memory_order_acquire); }
+
+    const std::string& getModelPath() const noexcept { return modelPath; }
+    const std::string& getScorerPath() const noexcept { return scorerPath; }
+
+private:
+    LibGenisysModel(std::string modelPath, std::string scorerPath);
+
+    bool load(const char* hotWords);
+
+    using HotWords = std::map<std::string, float>;
+    static bool ParseHotWords(const char* text, HotWords& words);
+    LibGenisysStatus ApplyHotWords(const HotWords& words);
+    void UpdateConfigurationHash();
+
+    using Key = std::pair<std::string, std::string>;
+    static std::mutex registryLock;
+    static std::map<Key, std::weak_ptr<LibGenisysModel>> registry;
+
+    const std::string modelPath;
+    const std::string scorerPath;
+
+    ModelState* ctx = nullptr;
+    bool scorerEnabled = false;
+
+    //Exclusive while hot words or scorer weights change, shared by everything else
+    mutable std::shared_timed_mutex decodingLock;
+    HotWords currentHotWords;
+    bool scorerWeightsSet = false;
+    float scorerAlpha = 0.0f;
+    float scorerBeta = 0.0f;
+    std::atomic<uint64_t> configurationHash { 0 };
+};
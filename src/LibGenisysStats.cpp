@@ -0,0 +1,174 @@
+#include "LibGenisysStats.h"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#include <intrin.h>
+#else
+#include <time.h>
+#endif
+
+namespace
+{
+int highestBit(uint64_t value) noexcept
+{
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanReverse64(&index, value);
+    return (int)index;
+#else
+    return 63 - __builtin_clzll(value);
+#endif
+}
+} // namespace
+
+//==============================================================================
+int LibGenisysHistogram::bucketFor(uint64_t value) noexcept
+{
+    constexpr uint64_t subBuckets = 1 << subBucketBits;
+
+    //Values below the first split each get a bucket of their own
+    if (value < subBuckets)
+        return (int)value;
+
+    const int shift = highestBit(value) - subBucketBits;
+    return int(((uint64_t)shift + 1) << subBucketBits) + int((value >> shift) & (subBuckets - 1));
+}
+
+uint64_t LibGenisysHistogram::bucketMidpoint(int bucket) noexcept
+{
+    constexpr int subBuckets = 1 << subBucketBits;
+
+    if (bucket < subBuckets)
+        return (uint64_t)bucket;
+
+    const int shift = (bucket >> subBucketBits) - 1;
+    const uint64_t lower = uint64_t(subBuckets + (bucket & (subBuckets - 1))) << shift;
+    return lower + ((uint64_t(1) << shift) >> 1);
+}
+
+void LibGenisysHistogram::record(uint64_t nanoseconds) noexcept
+{
+    buckets[size_t(bucketFor(nanoseconds))].fetch_add(1, std::memory_order_relaxed);
+    count.fetch_add(1, std::memory_order_relaxed);
+    total.fetch_add(nanoseconds, std::memory_order_relaxed);
+
+    auto previous = maximum.load(std::memory_order_relaxed);
+    while (previous < nanoseconds && !maximum.compare_exchange_weak(previous, nanoseconds, std::memory_order_relaxed))
+    {
+    }
+}
+
+void LibGenisysHistogram::reset() noexcept
+{
+    for (auto& bucket : buckets)
+        bucket.store(0, std::memory_order_relaxed);
+
+    count.store(0, std::memory_order_relaxed);
+    total.store(0, std::memory_order_relaxed);
+    maximum.store(0, std::memory_order_relaxed);
+}
+
+double LibGenisysHistogram::getPercentile(double p) const noexcept
+{
+    //Summed from the buckets rather than read from count, which may be ahead of them mid-record
+    uint64_t numValues = 0;
+    for (const auto& bucket : buckets)
+        numValues += bucket.load(std::memory_order_relaxed);
+
+    if (numValues == 0)
+        return 0.0;
+
+    const auto rank = std::max<uint64_t>(1, (uint64_t)std::ceil(std::min(std::max(p, 0.0), 1.0) * double(numValues)));
+
+    uint64_t seen = 0;
+    for (int i = 0; i < numBuckets; ++i)
+    {
+        seen += buckets[size_t(i)].load(std::memory_order_relaxed);
+
+        if (seen >= rank)
+            return double(std::min(bucketMidpoint(i), maximum.load(std::memory_order_relaxed))) * 1.0e-9;
+    }
+
+    return double(maximum.load(std::memory_order_relaxed)) * 1.0e-9;
+}
+
+//==============================================================================
+void LibGenisysStats::record(LibGenisysStage stage, uint64_t wallNanoseconds, uint64_t cpuNanoseconds) noexcept
+{
+    auto& timings = stages[size_t(stage)];
+    timings.wall.record(wallNanoseconds);
+    timings.cpu.record(cpuNanoseconds);
+}
+
+void LibGenisysStats::reset() noexcept
+{
+    for (auto& timings : stages)
+    {
+        timings.wall.reset();
+        timings.cpu.reset();
+    }
+}
+
+int LibGenisysStats::get(LibGenisysStageStats* stats, int maxStages) const noexcept
+{
+    const int numStages = std::min(maxStages, (int)LibGenisysStageCount);
+
+    for (int i = 0; i < numStages; ++i)
+    {
+        const auto& timings = stages[size_t(i)];
+        auto& out = stats[i];
+
+        out.stage = (LibGenisysStage)i;
+        out.name = getStageName(out.stage);
+        out.count = timings.wall.getCount();
+        out.wallTotal = timings.wall.getTotalSeconds();
+        out.wallP50 = timings.wall.getPercentile(0.50);
+        out.wallP95 = timings.wall.getPercentile(0.95);
+        out.wallP99 = timings.wall.getPercentile(0.99);
+        out.cpuTotal = timings.cpu.getTotalSeconds();
+        out.cpuP50 = timings.cpu.getPercentile(0.50);
+        out.cpuP95 = timings.cpu.getPercentile(0.95);
+        out.cpuP99 = timings.cpu.getPercentile(0.99);
+    }
+
+    return std::max(numStages, 0);
+}
+
+const char* LibGenisysStats::getStageName(LibGenisysStage stage) noexcept
+{
+    switch (stage)
+    {
+        case LibGenisysStageFileRead: return "read";
+        case LibGenisysStageConversion: return "convert";
+        case LibGenisysStageDenoise: return "denoise";
+        case LibGenisysStageResample: return "resample";
+        case LibGenisysStageFeed: return "feed";
+        case LibGenisysStageDecode: return "decode";
+        case LibGenisysStagePostProcess: return "postprocess";
+        case LibGenisysStageWakeWord: return "wakeword";
+        default: return "";
+    }
+}
+
+uint64_t LibGenisysStats::threadCpuNanoseconds() noexcept
+{
+#if defined(_WIN32)
+    FILETIME creation, exit, kernel, user;
+    if (!GetThreadTimes(GetCurrentThread(), &creation, &exit, &kernel, &user))
+        return 0;
+
+    //100ns units
+    const auto toTicks = [](const FILETIME& t) { return (uint64_t(t.dwHighDateTime) << 32) | t.dwLowDateTime; };
+    return (toTicks(kernel) + toTicks(user)) * 100;
+#else
+    timespec now {};
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+    return uint64_t(now.tv_sec) * 1000000000ull + uint64_t(now.tv_nsec);
+#endif
+}
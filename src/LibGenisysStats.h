@@ -0,0 +1,92 @@
+#pragma once
+
+#include "LibGenisysAPI.h"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+/**
+ * Lock-free latency histogram over nanoseconds
+ *
+ * Each power of two is split into four buckets, so a percentile is off by at
+ * most an eighth of its value. Recording is a handful of relaxed atomic adds,
+ * cheap enough to do per audio block from any number of threads.
+ */
+class LibGenisysHistogram
+{
+public:
+    void record(uint64_t nanoseconds) noexcept;
+    void reset() noexcept;
+
+    uint64_t getCount() const noexcept { return count.load(std::memory_order_relaxed); }
+    double getTotalSeconds() const noexcept { return double(total.load(std::memory_order_relaxed)) * 1.0e-9; }
+
+    /** @returns the value below which the fraction p of the recorded values fall, in seconds */
+    double getPercentile(double p) const noexcept;
+
+private:
+    static constexpr int subBucketBits = 2;
+    static constexpr int numBuckets = (64 - subBucketBits + 1) << subBucketBits;
+
+    static int bucketFor(uint64_t value) noexcept;
+    static uint64_t bucketMidpoint(int bucket) noexcept;
+
+    std::array<std::atomic<uint64_t>, numBuckets> buckets {};
+    std::atomic<uint64_t> count { 0 };
+    std::atomic<uint64_t> total { 0 };
+    std::atomic<uint64_t> maximum { 0 };
+};
+
+/**
+ * Wall and CPU time histograms for every LibGenisysStage of one instance
+ */
+class LibGenisysStats
+{
+public:
+    /** Times the enclosing scope as one run of a stage */
+    class Timer
+    {
+    public:
+        Timer(LibGenisysStats& owner_, LibGenisysStage stage_) noexcept
+            : owner(owner_), stage(stage_), wallStart(std::chrono::steady_clock::now()), cpuStart(threadCpuNanoseconds())
+        {
+        }
+
+        ~Timer()
+        {
+            const auto wall = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - wallStart);
+            owner.record(stage, uint64_t(wall.count()), threadCpuNanoseconds() - cpuStart);
+        }
+
+        Timer(const Timer&) = delete;
+        Timer& operator=(const Timer&) = delete;
+
+    private:
+        LibGenisysStats& owner;
+        const LibGenisysStage stage;
+        const std::chrono::steady_clock::time_point wallStart;
+        const uint64_t cpuStart;
+    };
+
+    void record(LibGenisysStage stage, uint64_t wallNanoseconds, uint64_t cpuNanoseconds) noexcept;
+    void reset() noexcept;
+
+    /** Fills up to maxStages entries in stage order and returns how many were written */
+    int get(LibGenisysStageStats* stats, int maxStages) const noexcept;
+
+    static const char* getStageName(LibGenisysStage stage) noexcept;
+
+    /** CPU time used by the calling thread, unlike clock() which counts the whole process */
+    static uint64_t threadCpuNanoseconds() noexcept;
+
+private:
+    struct Stage
+    {
+        LibGenisysHistogram wall;
+        LibGenisysHistogram cpu;
+    };
+
+    std::array<Stage, LibGenisysStageCount> stages;
+};
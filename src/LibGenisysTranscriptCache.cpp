@@ -0,0 +1,190 @@
+#include "LibGenisysTranscriptCache.h"
+
+#include <cstring>
+
+namespace
+{
+constexpr uint64_t prime1 = 0x9E3779B185EBCA87ull;
+constexpr uint64_t prime2 = 0xC2B2AE3D27D4EB4Full;
+constexpr uint64_t prime3 = 0x165667B19E3779F9ull;
+constexpr uint64_t prime4 = 0x85EBCA77C2B2AE63ull;
+constexpr uint64_t prime5 = 0x27D4EB2F165667C5ull;
+
+inline uint64_t rotateLeft(uint64_t value, int bits) noexcept
+{
+    return (value << bits) | (value >> (64 - bits));
+}
+
+inline uint64_t read64(const unsigned char* p) noexcept
+{
+    uint64_t value;
+    std::memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+inline uint64_t mixLane(uint64_t lane, uint64_t input) noexcept
+{
+    return rotateLeft(lane + input * prime2, 31) * prime1;
+}
+
+inline uint64_t mergeLane(uint64_t hash, uint64_t lane) noexcept
+{
+    return (hash ^ mixLane(0, lane)) * prime1 + prime4;
+}
+} // namespace
+
+//==============================================================================
+uint64_t LibGenisysTranscriptCache::hash(const void* data, size_t numBytes, uint64_t seed) noexcept
+{
+    auto p = static_cast<const unsigned char*>(data);
+    const auto end = p + numBytes;
+    uint64_t h;
+
+    if (numBytes >= 32)
+    {
+        //Four independent lanes keep the multipliers busy
+        uint64_t v1 = seed + prime1 + prime2, v2 = seed + prime2, v3 = seed, v4 = seed - prime1;
+
+        for (; end - p >= 32; p += 32)
+        {
+            v1 = mixLane(v1, read64(p));
+            v2 = mixLane(v2, read64(p + 8));
+            v3 = mixLane(v3, read64(p + 16));
+            v4 = mixLane(v4, read64(p + 24));
+        }
+
+        h = rotateLeft(v1, 1) + rotateLeft(v2, 7) + rotateLeft(v3, 12) + rotateLeft(v4, 18);
+        h = mergeLane(mergeLane(mergeLane(mergeLane(h, v1), v2), v3), v4);
+    }
+    else
+    {
+        h = seed + prime5;
+    }
+
+    h += numBytes;
+
+    for (; end - p >= 8; p += 8)
+        h = rotateLeft(h ^ mixLane(0, read64(p)), 27) * prime1 + prime4;
+
+    if (end - p >= 4)
+    {
+        uint32_t word;
+        std::memcpy(&word, p, sizeof(word));
+        h = rotateLeft(h ^ (uint64_t(word) * prime1), 23) * prime2 + prime3;
+        p += 4;
+    }
+
+    for (; p < end; ++p)
+        h = rotateLeft(h ^ (*p * prime5), 11) * prime1;
+
+    h ^= h >> 33;
+    h *= prime2;
+    h ^= h >> 29;
+    h *= prime3;
+    h ^= h >> 32;
+    return h;
+}
+
+LibGenisysTranscriptCache::Key LibGenisysTranscriptCache::makeKey(const void* pcm,
+                                                                  size_t numBytes,
+                                                                  uint64_t settings,
+                                                                  uint64_t configuration) noexcept
+{
+    Key key;
+    key.audio = hash(pcm, numBytes, settings);
+    key.configuration = configuration;
+    key.numBytes = numBytes;
+    return key;
+}
+
+//==============================================================================
+void LibGenisysTranscriptCache::setLimits(size_t newMaxEntries, size_t newMaxBytes)
+{
+    const std::lock_guard<std::mutex> guard(lock);
+
+    maxEntries = newMaxEntries;
+    maxBytes = newMaxBytes;
+    EvictToLimits();
+
+    enabled.store(maxEntries > 0 && maxBytes > 0, std::memory_order_relaxed);
+}
+
+bool LibGenisysTranscriptCache::lookup(const Key& key, std::string& transcript)
+{
+    const std::lock_guard<std::mutex> guard(lock);
+
+    const auto it = index.find(key);
+    if (it == index.end())
+    {
+        ++misses;
+        return false;
+    }
+
+    entries.splice(entries.begin(), entries, it->second);
+    transcript = it->second->transcript;
+    ++hits;
+    return true;
+}
+
+void LibGenisysTranscriptCache::insert(const Key& key, const std::string& transcript)
+{
+    const std::lock_guard<std::mutex> guard(lock);
+
+    if (maxEntries == 0 || sizeof(Entry) + transcript.size() > maxBytes)
+        return;
+
+    //Two batch workers can miss on the same audio, the later result replaces the earlier
+    const auto existing = index.find(key);
+    if (existing != index.end())
+    {
+        bytes -= EntryBytes(*existing->second);
+        entries.erase(existing->second);
+        index.erase(existing);
+    }
+
+    entries.push_front(Entry { key, transcript });
+    index[key] = entries.begin();
+    bytes += EntryBytes(entries.front());
+
+    EvictToLimits();
+}
+
+void LibGenisysTranscriptCache::clear()
+{
+    const std::lock_guard<std::mutex> guard(lock);
+
+    entries.clear();
+    index.clear();
+    bytes = 0;
+}
+
+void LibGenisysTranscriptCache::getStats(LibGenisysCacheStats& out) const
+{
+    const std::lock_guard<std::mutex> guard(lock);
+
+    out.hits = hits;
+    out.misses = misses;
+    out.evictions = evictions;
+    out.entries = entries.size();
+    out.bytes = bytes;
+}
+
+void LibGenisysTranscriptCache::resetStats()
+{
+    const std::lock_guard<std::mutex> guard(lock);
+
+    hits = 0;
+    misses = 0;
+    evictions = 0;
+}
+
+void LibGenisysTranscriptCache::EvictToLimits()
+{
+    while (!entries.empty() && (entries.size() > maxEntries || bytes > maxBytes))
+    {
+        bytes -= EntryBytes(entries.back());
+        index.erase(entries.back().key);
+        entries.pop_back();
+        ++evictions;
+    }
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "LibGenisysAPI.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+/**
+ * Least recently used cache of final transcripts, keyed by audio content
+ *
+ * A key pairs a hash of the 16-bit PCM that would go to DeepSpeech with hashes of
+ * everything else that shapes the transcript: the instance's endpointing and output
+ * settings, and the model, scorer, hot words and scorer weights. The cache is bounded
+ * by entry count and by the bytes it holds, and stays off until limits are set.
+ * Every call locks, so batch workers can share it.
+ */
+class LibGenisysTranscriptCache
+{
+public:
+    struct Key
+    {
+        uint64_t audio = 0; //The PCM data, hashed with the instance's settings as seed
+        uint64_t configuration = 0; //The model's, see LibGenisysModel::getConfigurationHash
+        size_t numBytes = 0;
+
+        bool operator==(const Key& other) const noexcept
+        {
+            return audio == other.audio && configuration == other.configuration && numBytes == other.numBytes;
+        }
+    };
+
+    /** 64-bit content hash on XXH64's construction, a few GB/s; not for anything adversarial */
+    static uint64_t hash(const void* data, size_t numBytes, uint64_t seed = 0) noexcept;
+
+    static Key makeKey(const void* pcm, size_t numBytes, uint64_t settings, uint64_t configuration) noexcept;
+
+    /** Sets the bounds and evicts down to them, a zero bound turns the cache off and empties it */
+    void setLimits(size_t maxEntries, size_t maxBytes);
+    bool isEnabled() const noexcept { return enabled.load(std::memory_order_relaxed); }
+
+    /** Copies out the transcript stored for key and marks it most recently used */
+    bool lookup(const Key& key, std::string& transcript);
+    void insert(const Key& key, const std::string& transcript);
+    void clear();
+
+    void getStats(LibGenisysCacheStats& out) const;
+    void resetStats();
+
+private:
+    struct Entry
+    {
+        Key key;
+        std::string transcript;
+    };
+
+    struct KeyHash
+    {
+        size_t operator()(const Key& key) const noexcept
+        {
+            return size_t(key.audio ^ (key.configuration * 0x9E3779B97F4A7C15ull));
+        }
+    };
+
+    static size_t EntryBytes(const Entry& entry) noexcept { return sizeof(Entry) + entry.transcript.size(); }
+    void EvictToLimits();
+
+    std::atomic<bool> enabled { false };
+
+    mutable std::mutex lock;
+    std::list<Entry> entries; //Most recently used first
+    std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> index;
+    size_t maxEntries = 0;
+    size_t maxBytes = 0;
+    size_t bytes = 0;
+
+    unsigned long long hits = 0;
+    unsigned long long misses = 0;
+    unsigned long long evictions = 0;
+};
@@ -0,0 +1,175 @@
+//==============================================================================
+/** Timing and JSON output shared by dspbench and meterbench.
+
+    Each case is calibrated until one batch of calls takes at least a tenth of
+    the time budget, then timed over several batches. The median batch is the
+    number to track and the fastest shows how much of the spread is noise.
+    Results go to stdout as one JSON document, so runs can be diffed or
+    loaded into a dashboard without scraping.
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace BenchReport
+{
+struct Measurement
+{
+    int64_t iterations = 0;
+    double medianNs = 0.0;
+    double minNs = 0.0;
+};
+
+struct Options
+{
+    double secondsPerCase = 0.25;
+    int repetitions = 5;
+};
+
+/** Stops the compiler dropping work whose result is never used */
+template <typename T>
+inline void keep(const T& value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static const T* volatile sink;
+    sink = &value;
+#endif
+}
+
+/** Times fn(), one call per operation, and returns the cost per call */
+template <typename Fn>
+Measurement measure(const Options& options, Fn&& fn)
+{
+    using Clock = std::chrono::steady_clock;
+
+    const double batchSeconds = options.secondsPerCase / std::max(1, options.repetitions);
+
+    auto runBatch = [&fn](int64_t calls)
+    {
+        const auto start = Clock::now();
+        for (int64_t i = 0; i < calls; ++i)
+            fn();
+        return std::chrono::duration<double>(Clock::now() - start).count();
+    };
+
+    //Also warms caches and branch predictors
+    int64_t calls = 1;
+    for (double elapsed = runBatch(calls); elapsed < batchSeconds * 0.1 && calls < (int64_t(1) << 40);)
+    {
+        calls *= elapsed > 0.0 ? std::max<int64_t>(2, std::min<int64_t>(100, int64_t(batchSeconds * 0.1 / elapsed))) : 100;
+        elapsed = runBatch(calls);
+    }
+
+    calls = std::max<int64_t>(1, calls * 10);
+
+    std::vector<double> perCall;
+    for (int r = 0; r < std::max(1, options.repetitions); ++r)
+        perCall.push_back(runBatch(calls) * 1.0e9 / double(calls));
+
+    std::sort(perCall.begin(), perCall.end());
+
+    Measurement result;
+    result.iterations = calls * int64_t(perCall.size());
+    result.medianNs = perCall[perCall.size() / 2];
+    result.minNs = perCall.front();
+    return result;
+}
+
+//==============================================================================
+/** Collects results and writes them as {"tool": ..., "results": [...]} */
+class Report
+{
+public:
+    explicit Report(std::string toolName) : tool(std::move(toolName)) {}
+
+    /** A case parameter, either a number or a string */
+    struct Param
+    {
+        Param(const char* k, const char* v) : key(k), value(quote(v)) {}
+        Param(const char* k, const std::string& v) : key(k), value(quote(v)) {}
+        Param(const char* k, double v) : key(k), value(number(v)) {}
+        Param(const char* k, int v) : key(k), value(std::to_string(v)) {}
+
+        std::string key, value;
+    };
+
+    /** Adds a result, itemsPerCall is the number of samples or items each call handles */
+    void add(const std::string& group,
+             const std::string& name,
+             const std::vector<Param>& params,
+             const Measurement& m,
+             double itemsPerCall)
+    {
+        std::string entry = "    {\"group\": " + quote(group) + ", \"name\": " + quote(name) + ", \"params\": {";
+
+        for (size_t i = 0; i < params.size(); ++i)
+            entry += (i > 0 ? ", " : "") + quote(params[i].key) + ": " + params[i].value;
+
+        entry += "}, \"iterations\": " + std::to_string(m.iterations);
+        entry += ", \"ns_per_call\": " + number(m.medianNs);
+        entry += ", \"min_ns_per_call\": " + number(m.minNs);
+        entry += ", \"items_per_call\": " + number(itemsPerCall);
+        entry += ", \"items_per_second\": " + number(m.medianNs > 0.0 ? itemsPerCall * 1.0e9 / m.medianNs : 0.0);
+        entry += "}";
+
+        entries.push_back(entry);
+        std::fprintf(stderr, "%-12s %-40s %12.1f ns\n", group.c_str(), name.c_str(), m.medianNs);
+    }
+
+    void write(std::FILE* out) const
+    {
+        std::fprintf(out, "{\n  \"tool\": %s,\n  \"results\": [\n", quote(tool).c_str());
+
+        for (size_t i = 0; i < entries.size(); ++i)
+            std::fprintf(out, "%s%s\n", entries[i].c_str(), i + 1 < entries.size() ? "," : "");
+
+        std::fprintf(out, "  ]\n}\n");
+    }
+
+    static std::string quote(const std::string& text)
+    {
+        std::string quoted = "\"";
+        for (const char c : text)
+        {
+            if (c == '"' || c == '\\')
+                quoted += '\\';
+            quoted += c;
+        }
+        return quoted + "\"";
+    }
+
+    static std::string number(double value)
+    {
+        char text[32];
+        std::snprintf(text, sizeof(text), "%.6g", value);
+        return text;
+    }
+
+private:
+    std::string tool;
+    std::vector<std::string> entries;
+};
+
+/** Parses the optional [secondsPerCase] [filter] arguments both tools take */
+inline Options parseOptions(int argc, char* argv[], std::string& filter)
+{
+    Options options;
+
+    if (argc > 1)
+        options.secondsPerCase = std::max(0.001, std::atof(argv[1]));
+    if (argc > 2)
+        filter = argv[2];
+
+    return options;
+}
+} // namespace BenchReport
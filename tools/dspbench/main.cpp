@@ -0,0 +1,549 @@
+//==============================================================================
+/** dspbench - microbenchmarks for the libgenisys-dsp primitives.
+
+    Covers the resampler at every device rate and engine, each libsamplerate
+    converter, AudioFifo block copies, AbstractFifo and SpscFifo under
+    producer/consumer contention, the AudioDataConverters against the per-sample
+    loops they replaced and the FloatVectorOperations kernels. LevelMeterSource
+    needs the real JUCE, so it lives in meterbench next door and reports in the
+    same format.
+
+    The contention cases check every item arrives in order and the converters
+    match their scalar reference bit for bit. A failed check is flagged in the
+    case's params and on stderr, and the exit code is 1.
+
+    The JSON report goes to stdout and a readable summary to stderr:
+
+        dspbench [secondsPerCase] [filter] > dsp.json
+
+    filter only runs cases whose group or name contains it, e.g. "fvo".
+*/
+
+#include "benchreport.h"
+
+#include "genisys/genisys_spscfifo.h"
+#include "gin/gin_audiofifo.h"
+#include "gin/gin_resamplingfifo.h"
+#include "juce/juce_AbstractFifo.h"
+#include "juce/juce_AudioDataConverters.h"
+#include "juce/juce_FloatVectorOperations.h"
+#include "libsamplerate/samplerate.h"
+
+#include <cstring>
+#include <functional>
+#include <random>
+#include <thread>
+
+namespace
+{
+using BenchReport::keep;
+using BenchReport::measure;
+using BenchReport::Options;
+using BenchReport::Report;
+
+std::vector<float> makeNoise(int numSamples, float gain = 0.5f)
+{
+    std::mt19937 rng(1234);
+    std::uniform_real_distribution<float> dist(-gain, gain);
+
+    std::vector<float> samples(size_t(std::max(numSamples, 0)));
+    for (auto& s : samples)
+        s = dist(rng);
+
+    return samples;
+}
+
+bool selected(const std::string& filter, const std::string& group, const std::string& name)
+{
+    return filter.empty() || group.find(filter) != std::string::npos || name.find(filter) != std::string::npos;
+}
+
+//Set by any case whose output fails its check
+bool checksFailed = false;
+
+int check(bool passed, const std::string& group, const std::string& name, const char* failure)
+{
+    if (!passed)
+    {
+        std::fprintf(stderr, "%-12s %-40s %s\n", group.c_str(), name.c_str(), failure);
+        checksFailed = true;
+    }
+
+    return passed ? 1 : 0;
+}
+
+//==============================================================================
+void benchResamplingFifo(Report& report, const Options& options, const std::string& filter)
+{
+    const int inputRates[] = { 8000, 16000, 44100, 48000, 96000 };
+    const int blockSizes[] = { 64, 256, 480, 1024 };
+    const std::pair<ResamplingFifo::Engine, const char*> engines[] = {
+        { ResamplingFifo::Engine::polyphase, "polyphase" },
+        { ResamplingFifo::Engine::sincFastest, "sinc_fastest" },
+    };
+
+    for (const auto& engine : engines)
+    {
+        for (const int rate : inputRates)
+        {
+            for (const int blockSize : blockSizes)
+            {
+                const auto name = "push_" + std::string(engine.second) + "_" + std::to_string(rate) + "_" + std::to_string(blockSize);
+                if (!selected(filter, "resampler", name))
+                    continue;
+
+                ResamplingFifo fifo(blockSize, 1, 96000 * 2);
+                fifo.setEngine(engine.first);
+                fifo.setResamplingRatio(rate, 16000);
+                fifo.reset();
+
+                auto input = makeNoise(blockSize);
+                float* channels[] = { input.data() };
+                const juce::AudioSampleBuffer block(channels, 1, blockSize);
+
+                //Drained in place every call, the way LibGenisysImpl reads it
+                const auto m = measure(options,
+                                       [&]
+                                       {
+                                           fifo.pushAudioBuffer(block);
+                                           fifo.finishedRead(fifo.prepareToRead(fifo.samplesReady()).getNumSamples());
+                                       });
+
+                report.add("resampler",
+                           name,
+                           { { "engine", fifo.isUsingPolyphase() ? "polyphase" : "sinc_fastest" },
+                             { "input_rate", rate },
+                             { "output_rate", 16000 },
+                             { "block_size", blockSize } },
+                           m,
+                           blockSize);
+            }
+        }
+    }
+}
+
+void benchLibsamplerate(Report& report, const Options& options, const std::string& filter)
+{
+    const std::pair<int, const char*> converters[] = {
+        { SRC_SINC_BEST_QUALITY, "sinc_best" },  { SRC_SINC_MEDIUM_QUALITY, "sinc_medium" },
+        { SRC_SINC_FASTEST, "sinc_fastest" },    { SRC_ZERO_ORDER_HOLD, "zero_order_hold" },
+        { SRC_LINEAR, "linear" },
+    };
+    const int inputRates[] = { 44100, 48000 };
+    const int blockSize = 480;
+
+    for (const auto& converter : converters)
+    {
+        for (const int rate : inputRates)
+        {
+            const auto name = std::string(converter.second) + "_" + std::to_string(rate);
+            if (!selected(filter, "samplerate", name))
+                continue;
+
+            int error = 0;
+            SRC_STATE* state = src_new(converter.first, 1, &error);
+            if (!state)
+            {
+                std::fprintf(stderr, "samplerate   %-40s unavailable: %s\n", name.c_str(), src_strerror(error));
+                continue;
+            }
+
+            const double ratio = 16000.0 / rate;
+            auto input = makeNoise(blockSize);
+            std::vector<float> output(size_t(blockSize * ratio) + 64);
+
+            SRC_DATA data {};
+            data.src_ratio = ratio;
+
+            const auto m = measure(options,
+                                   [&]
+                                   {
+                                       data.data_in = input.data();
+                                       data.input_frames = blockSize;
+                                       data.data_out = output.data();
+                                       data.output_frames = (long)output.size();
+                                       src_process(state, &data);
+                                       keep(data.output_frames_gen);
+                                   });
+
+            src_delete(state);
+
+            report.add("samplerate",
+                       name,
+                       { { "converter", converter.second }, { "input_rate", rate }, { "output_rate", 16000 }, { "block_size", blockSize } },
+                       m,
+                       blockSize);
+        }
+    }
+}
+
+//==============================================================================
+void benchAudioFifo(Report& report, const Options& options, const std::string& filter)
+{
+    const int blockSizes[] = { 64, 480, 4096 };
+
+    for (const int numChannels : { 1, 2 })
+    {
+        for (const int blockSize : blockSizes)
+        {
+            const auto name = "write_read_" + std::to_string(numChannels) + "ch_" + std::to_string(blockSize);
+            if (!selected(filter, "audiofifo", name))
+                continue;
+
+            //An odd capacity so blocks keep landing across the wrap
+            AudioFifo fifo(numChannels, blockSize * 3 + 17);
+            juce::AudioSampleBuffer input(numChannels, blockSize), output(numChannels, blockSize);
+
+            for (int ch = 0; ch < numChannels; ++ch)
+            {
+                const auto noise = makeNoise(blockSize);
+                input.copyFrom(ch, 0, noise.data(), blockSize);
+            }
+
+            const auto m = measure(options,
+                                   [&]
+                                   {
+                                       fifo.write(input);
+                                       fifo.read(output);
+                                   });
+
+            report.add("audiofifo",
+                       name,
+                       { { "channels", numChannels }, { "block_size", blockSize } },
+                       m,
+                       double(blockSize) * numChannels);
+        }
+    }
+}
+
+template <typename Fifo>
+BenchReport::Measurement runContention(const Options& options, int capacity, int blockSize, bool& ordered)
+{
+    //Sized so a run takes roughly its share of the budget on a current desktop
+    const int numItems = std::max(100000, int(options.secondsPerCase / std::max(1, options.repetitions) * 2.0e8));
+
+    std::vector<double> perItem;
+    for (int r = 0; r < std::max(1, options.repetitions); ++r)
+    {
+        Fifo fifo(capacity);
+        std::vector<int> storage(size_t(capacity), 0);
+
+        const auto start = std::chrono::steady_clock::now();
+
+        std::thread producer(
+            [&]
+            {
+                for (int next = 0; next < numItems;)
+                {
+                    int start1, size1, start2, size2;
+                    fifo.prepareToWrite(std::min(blockSize, numItems - next), start1, size1, start2, size2);
+
+                    for (int i = 0; i < size1; ++i)
+                        storage[size_t(start1 + i)] = next++;
+                    for (int i = 0; i < size2; ++i)
+                        storage[size_t(start2 + i)] = next++;
+
+                    fifo.finishedWrite(size1 + size2);
+
+                    if (size1 + size2 == 0)
+                        std::this_thread::yield();
+                }
+            });
+
+        //The producer writes a running sequence, so the consumer can check nothing is lost or reordered
+        for (int expected = 0; expected < numItems;)
+        {
+            int start1, size1, start2, size2;
+            fifo.prepareToRead(blockSize, start1, size1, start2, size2);
+
+            for (int i = 0; i < size1; ++i)
+                ordered &= storage[size_t(start1 + i)] == expected++;
+            for (int i = 0; i < size2; ++i)
+                ordered &= storage[size_t(start2 + i)] == expected++;
+
+            fifo.finishedRead(size1 + size2);
+
+            //Only matters when the two threads share a core
+            if (size1 + size2 == 0)
+                std::this_thread::yield();
+        }
+
+        producer.join();
+
+        perItem.push_back(std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / numItems);
+    }
+
+    std::sort(perItem.begin(), perItem.end());
+
+    BenchReport::Measurement m;
+    m.iterations = int64_t(numItems) * int64_t(perItem.size());
+    m.medianNs = perItem[perItem.size() / 2];
+    m.minNs = perItem.front();
+    return m;
+}
+
+void benchFifoContention(Report& report, const Options& options, const std::string& filter)
+{
+    const int capacity = 1024;
+
+    for (const int blockSize : { 1, 4, 16, 256 })
+    {
+        const auto suffix = "_" + std::to_string(blockSize);
+
+        if (selected(filter, "contention", "abstract_fifo" + suffix))
+        {
+            bool ordered = true;
+            const auto m = runContention<juce::AbstractFifo>(options, capacity, blockSize, ordered);
+
+            report.add("contention",
+                       "abstract_fifo" + suffix,
+                       { { "fifo", "juce::AbstractFifo" },
+                         { "capacity", capacity },
+                         { "block_size", blockSize },
+                         { "ordered", check(ordered, "contention", "abstract_fifo" + suffix, "OUT OF ORDER") } },
+                       m,
+                       1);
+        }
+
+        if (selected(filter, "contention", "spsc_fifo" + suffix))
+        {
+            bool ordered = true;
+            const auto m = runContention<SpscFifo>(options, capacity, blockSize, ordered);
+
+            report.add("contention",
+                       "spsc_fifo" + suffix,
+                       { { "fifo", "SpscFifo" },
+                         { "capacity", capacity },
+                         { "block_size", blockSize },
+                         { "ordered", check(ordered, "contention", "spsc_fifo" + suffix, "OUT OF ORDER") } },
+                       m,
+                       1);
+        }
+    }
+}
+
+//==============================================================================
+// The per-sample loops the packed little endian converters had, kept as the reference they must match
+void scalarFloatToInt16(const float* source, void* dest, int numSamples)
+{
+    const auto maxVal = (double)0x7fff;
+    auto intData = static_cast<char*>(dest);
+
+    for (int i = 0; i < numSamples; ++i, intData += 2)
+        *juce::unalignedPointerCast<juce::uint16*>(intData) = juce::ByteOrder::swapIfBigEndian(
+            (juce::uint16)(short)juce::roundToInt(juce::jlimit(-maxVal, maxVal, maxVal * source[i])));
+}
+
+void scalarFloatToInt24(const float* source, void* dest, int numSamples)
+{
+    const auto maxVal = (double)0x7fffff;
+    auto intData = static_cast<char*>(dest);
+
+    for (int i = 0; i < numSamples; ++i, intData += 3)
+        juce::ByteOrder::littleEndian24BitToChars(juce::roundToInt(juce::jlimit(-maxVal, maxVal, maxVal * source[i])), intData);
+}
+
+void scalarFloatToInt32(const float* source, void* dest, int numSamples)
+{
+    const auto maxVal = (double)0x7fffffff;
+    auto intData = static_cast<char*>(dest);
+
+    for (int i = 0; i < numSamples; ++i, intData += 4)
+        *juce::unalignedPointerCast<juce::uint32*>(intData) = juce::ByteOrder::swapIfBigEndian(
+            (juce::uint32)juce::roundToInt(juce::jlimit(-maxVal, maxVal, maxVal * source[i])));
+}
+
+void scalarInt16ToFloat(const void* source, float* dest, int numSamples)
+{
+    const float scale = 1.0f / 0x7fff;
+    auto intData = static_cast<const char*>(source);
+
+    for (int i = 0; i < numSamples; ++i, intData += 2)
+        dest[i] = scale * (short)juce::ByteOrder::swapIfBigEndian(*juce::unalignedPointerCast<const juce::uint16*>(intData));
+}
+
+void scalarInt24ToFloat(const void* source, float* dest, int numSamples)
+{
+    const float scale = 1.0f / 0x7fffff;
+    auto intData = static_cast<const char*>(source);
+
+    for (int i = 0; i < numSamples; ++i, intData += 3)
+        dest[i] = scale * (float)juce::ByteOrder::littleEndian24Bit(intData);
+}
+
+void scalarInt32ToFloat(const void* source, float* dest, int numSamples)
+{
+    const float scale = 1.0f / (float)0x7fffffff;
+    auto intData = static_cast<const char*>(source);
+
+    for (int i = 0; i < numSamples; ++i, intData += 4)
+        dest[i] = scale * (float)(int)juce::ByteOrder::swapIfBigEndian(*juce::unalignedPointerCast<const juce::uint32*>(intData));
+}
+
+// wavio's own loops from before it used the converters, they truncate so only the speed compares
+void wavioFloatToInt16(const float* source, void* dest, int numSamples)
+{
+    auto out = static_cast<juce::int16*>(dest);
+
+    for (int i = 0; i < numSamples; ++i)
+        out[i] = static_cast<juce::int16>(std::min(std::max(source[i], -1.0f), 1.0f) * 0x7fff);
+}
+
+void wavioInt16ToFloat(const void* source, float* dest, int numSamples)
+{
+    auto in = static_cast<const juce::int16*>(source);
+
+    for (int i = 0; i < numSamples; ++i)
+        dest[i] = std::min(std::max(static_cast<float>(in[i]) / 0x7fff, -1.0f), 1.0f);
+}
+
+void benchConverters(Report& report, const Options& options, const std::string& filter)
+{
+    using Converters = juce::AudioDataConverters;
+
+    const int numSamples = 4096;
+    const auto input = makeNoise(numSamples, 1.2f);
+    std::vector<char> packedInput(size_t(numSamples) * 4 + 4), packed(packedInput.size()), packedReference(packedInput.size());
+    std::vector<float> output((size_t)numSamples), outputReference((size_t)numSamples);
+
+    //Filled once so the int to float cases read real data
+    Converters::convertFloatToInt32LE(input.data(), packedInput.data(), numSamples);
+
+    auto run = [&](const std::string& name, std::vector<Report::Param> params, const std::function<void()>& fn)
+    {
+        if (!selected(filter, "converters", name))
+            return;
+
+        const auto m = measure(options,
+                               [&]
+                               {
+                                   fn();
+                                   keep(packed[0]);
+                                   keep(output[0]);
+                               });
+
+        params.push_back({ "block_size", numSamples });
+        report.add("converters", name, params, m, numSamples);
+    };
+
+    //Each vectorised converter is timed next to its scalar reference, and the two must match bit for bit
+    struct FromFloat
+    {
+        const char* name;
+        void (*simd)(const float*, void*, int, int);
+        void (*scalar)(const float*, void*, int);
+        int bytesPerSample;
+    };
+
+    const FromFloat fromFloat[] = {
+        { "float_to_int16le", Converters::convertFloatToInt16LE, scalarFloatToInt16, 2 },
+        { "float_to_int24le", Converters::convertFloatToInt24LE, scalarFloatToInt24, 3 },
+        { "float_to_int32le", Converters::convertFloatToInt32LE, scalarFloatToInt32, 4 },
+    };
+
+    for (const auto& c : fromFloat)
+    {
+        c.simd(input.data(), packed.data(), numSamples, c.bytesPerSample);
+        c.scalar(input.data(), packedReference.data(), numSamples);
+        const bool same = std::memcmp(packed.data(), packedReference.data(), size_t(numSamples * c.bytesPerSample)) == 0;
+        const int matches = check(same, "converters", c.name, "MISMATCH");
+
+        run(c.name, { { "impl", "simd" }, { "matches_scalar", matches } },
+            [&] { c.simd(input.data(), packed.data(), numSamples, c.bytesPerSample); });
+        run(std::string(c.name) + "_scalar", { { "impl", "scalar" } },
+            [&] { c.scalar(input.data(), packed.data(), numSamples); });
+    }
+
+    struct ToFloat
+    {
+        const char* name;
+        void (*simd)(const void*, float*, int, int);
+        void (*scalar)(const void*, float*, int);
+        int bytesPerSample;
+    };
+
+    const ToFloat toFloat[] = {
+        { "int16le_to_float", Converters::convertInt16LEToFloat, scalarInt16ToFloat, 2 },
+        { "int24le_to_float", Converters::convertInt24LEToFloat, scalarInt24ToFloat, 3 },
+        { "int32le_to_float", Converters::convertInt32LEToFloat, scalarInt32ToFloat, 4 },
+    };
+
+    for (const auto& c : toFloat)
+    {
+        c.simd(packedInput.data(), output.data(), numSamples, c.bytesPerSample);
+        c.scalar(packedInput.data(), outputReference.data(), numSamples);
+        const bool same = std::memcmp(output.data(), outputReference.data(), size_t(numSamples) * sizeof(float)) == 0;
+        const int matches = check(same, "converters", c.name, "MISMATCH");
+
+        run(c.name, { { "impl", "simd" }, { "matches_scalar", matches } },
+            [&] { c.simd(packedInput.data(), output.data(), numSamples, c.bytesPerSample); });
+        run(std::string(c.name) + "_scalar", { { "impl", "scalar" } },
+            [&] { c.scalar(packedInput.data(), output.data(), numSamples); });
+    }
+
+    run("float_to_int16le_wavio", { { "impl", "wavio" } }, [&] { wavioFloatToInt16(input.data(), packed.data(), numSamples); });
+    run("int16le_to_float_wavio", { { "impl", "wavio" } }, [&] { wavioInt16ToFloat(packedInput.data(), output.data(), numSamples); });
+}
+
+template <typename FloatType>
+void benchVectorOps(Report& report, const Options& options, const std::string& filter, const char* typeName)
+{
+    using FVO = juce::FloatVectorOperations;
+
+    for (const int numSamples : { 64, 480, 4096 })
+    {
+        std::vector<FloatType> a((size_t)numSamples), b((size_t)numSamples), dest((size_t)numSamples);
+        const auto noiseA = makeNoise(numSamples), noiseB = makeNoise(numSamples);
+        std::copy(noiseA.begin(), noiseA.end(), a.begin());
+        std::copy(noiseB.begin(), noiseB.end(), b.begin());
+
+        //add_with_multiply accumulates into dest, which only drifts by a's values per call
+        const std::pair<const char*, std::function<void()>> cases[] = {
+            { "copy", [&] { FVO::copy(dest.data(), a.data(), numSamples); } },
+            { "add", [&] { FVO::add(dest.data(), a.data(), b.data(), numSamples); } },
+            { "multiply", [&] { FVO::multiply(dest.data(), a.data(), b.data(), numSamples); } },
+            { "copy_with_multiply", [&] { FVO::copyWithMultiply(dest.data(), a.data(), FloatType(0.5), numSamples); } },
+            { "add_with_multiply", [&] { FVO::addWithMultiply(dest.data(), a.data(), b.data(), numSamples); } },
+            { "clip", [&] { FVO::clip(dest.data(), a.data(), FloatType(-0.25), FloatType(0.25), numSamples); } },
+            { "abs", [&] { FVO::abs(dest.data(), a.data(), numSamples); } },
+            { "find_min_and_max", [&] { keep(FVO::findMinAndMax(a.data(), numSamples)); } },
+        };
+
+        for (const auto& c : cases)
+        {
+            const auto name = std::string(c.first) + "_" + typeName + "_" + std::to_string(numSamples);
+            if (!selected(filter, "fvo", name))
+                continue;
+
+            const auto m = measure(options,
+                                   [&]
+                                   {
+                                       c.second();
+                                       keep(dest[0]);
+                                   });
+
+            report.add("fvo", name, { { "op", c.first }, { "type", typeName }, { "block_size", numSamples } }, m, numSamples);
+        }
+    }
+}
+} // namespace
+
+//==============================================================================
+int main(int argc, char* argv[])
+{
+    std::string filter;
+    const auto options = BenchReport::parseOptions(argc, argv, filter);
+
+    Report report("dspbench");
+
+    benchResamplingFifo(report, options, filter);
+    benchLibsamplerate(report, options, filter);
+    benchAudioFifo(report, options, filter);
+    benchFifoContention(report, options, filter);
+    benchConverters(report, options, filter);
+    benchVectorOps<float>(report, options, filter, "float");
+    benchVectorOps<double>(report, options, filter, "double");
+
+    report.write(stdout);
+    return checksFailed ? 1 : 0;
+}
@@ -0,0 +1,176 @@
+//==============================================================================
+/** meterbench - microbenchmarks for the ff_meters audio thread paths.
+
+    LevelMeterSource, OutlineBuffer and StereoFieldBuffer are built on the
+    full JUCE modules rather than the libgenisys-dsp subset, so they get their
+    own executable. The output matches dspbench:
+
+        meterbench [secondsPerCase] [filter] > meters.json
+*/
+
+#include "benchreport.h"
+
+#include <ff_meters/ff_meters.h>
+
+#include <random>
+
+namespace
+{
+using BenchReport::keep;
+using BenchReport::measure;
+using BenchReport::Options;
+using BenchReport::Report;
+
+juce::AudioBuffer<float> makeNoise(int numChannels, int numSamples)
+{
+    std::mt19937 rng(1234);
+    std::uniform_real_distribution<float> dist(-0.5f, 0.5f);
+
+    juce::AudioBuffer<float> buffer(numChannels, numSamples);
+    for (int ch = 0; ch < numChannels; ++ch)
+        for (int i = 0; i < numSamples; ++i)
+            buffer.setSample(ch, i, dist(rng));
+
+    return buffer;
+}
+
+bool selected(const std::string& filter, const std::string& group, const std::string& name)
+{
+    return filter.empty() || group.find(filter) != std::string::npos || name.find(filter) != std::string::npos;
+}
+
+const int blockSizes[] = { 64, 480, 4096 };
+
+//==============================================================================
+void benchLevelMeterSource(Report& report, const Options& options, const std::string& filter)
+{
+    for (const int numChannels : { 1, 2, 32 })
+    {
+        for (const int blockSize : blockSizes)
+        {
+            const auto name = "measure_block_" + std::to_string(numChannels) + "ch_" + std::to_string(blockSize);
+            if (!selected(filter, "meters", name))
+                continue;
+
+            //A 100ms window at 48kHz, as a plugin would set it in prepareToPlay
+            const int rmsWindow = std::max(1, 4800 / blockSize);
+
+            foleys::LevelMeterSource source;
+            source.resize(numChannels, rmsWindow);
+            const auto buffer = makeNoise(numChannels, blockSize);
+
+            const auto m = measure(options,
+                                   [&]
+                                   {
+                                       source.measureBlock(buffer);
+                                       keep(source.getRMSLevel(0));
+                                   });
+
+            report.add("meters",
+                       name,
+                       { { "channels", numChannels }, { "block_size", blockSize }, { "rms_window", rmsWindow } },
+                       m,
+                       double(blockSize) * numChannels);
+        }
+    }
+}
+
+void benchOutlineBuffer(Report& report, const Options& options, const std::string& filter)
+{
+    for (const int blockSize : blockSizes)
+    {
+        const auto name = "outline_push_block_2ch_" + std::to_string(blockSize);
+        if (!selected(filter, "meters", name))
+            continue;
+
+        foleys::OutlineBuffer outline;
+        outline.setSize(2, 1024);
+        outline.setSamplesPerBlock(128);
+        const auto buffer = makeNoise(2, blockSize);
+
+        const auto m = measure(options, [&] { outline.pushBlock(buffer, blockSize); });
+
+        report.add("meters", name, { { "channels", 2 }, { "block_size", blockSize } }, m, double(blockSize) * 2);
+    }
+
+    //Repainting a recording history: ten minutes of 128-sample blocks at 48kHz into 800 pixels
+    for (const int numBlocks : { 800, 225000 })
+    {
+        const auto name = "outline_path_2ch_" + std::to_string(numBlocks);
+        if (!selected(filter, "meters", name))
+            continue;
+
+        foleys::OutlineBuffer outline;
+        outline.setSamplesPerBlock(128);
+        outline.setSize(2, 225000 + 16);
+        const auto buffer = makeNoise(2, 4096);
+        for (int i = 0; i < 225000 * 128 / 4096; ++i)
+            outline.pushBlock(buffer, 4096);
+
+        const juce::Rectangle<float> bounds(0.0f, 0.0f, 800.0f, 200.0f);
+        const auto m = measure(options,
+                               [&]
+                               {
+                                   juce::Path path;
+                                   outline.getChannelOutline(path, bounds, numBlocks);
+                                   keep(path.getBounds());
+                               });
+
+        report.add("meters", name, { { "channels", 2 }, { "blocks", numBlocks }, { "width", 800 } }, m, double(numBlocks) * 2);
+    }
+}
+
+void benchStereoFieldBuffer(Report& report, const Options& options, const std::string& filter)
+{
+    for (const int blockSize : blockSizes)
+    {
+        const auto name = "stereo_field_push_block_" + std::to_string(blockSize);
+        if (!selected(filter, "meters", name))
+            continue;
+
+        foleys::StereoFieldBuffer<float> field;
+        field.setBufferSize(2, 4 * 4096 + 17);
+        const auto buffer = makeNoise(2, blockSize);
+
+        const auto m = measure(options, [&] { field.pushSampleBlock(buffer, blockSize); });
+
+        report.add("meters", name, { { "channels", 2 }, { "block_size", blockSize } }, m, double(blockSize) * 2);
+    }
+
+    //What the GUI pays per frame for the direction histogram of a full window
+    const auto name = std::string("stereo_field_directions_4096");
+    if (!selected(filter, "meters", name))
+        return;
+
+    foleys::StereoFieldBuffer<float> field;
+    field.setBufferSize(2, 4 * 4096 + 17);
+    const auto buffer = makeNoise(2, 4096);
+    field.pushSampleBlock(buffer, 4096);
+
+    std::vector<float> directions(foleys::StereoFieldBuffer<float>::numDirections);
+    const auto m = measure(options,
+                           [&]
+                           {
+                               field.getDirections(directions, 4096, 0, 1);
+                               keep(directions[90]);
+                           });
+
+    report.add("meters", name, { { "channels", 2 }, { "window", 4096 } }, m, 4096.0);
+}
+} // namespace
+
+//==============================================================================
+int main(int argc, char* argv[])
+{
+    std::string filter;
+    const auto options = BenchReport::parseOptions(argc, argv, filter);
+
+    Report report("meterbench");
+
+    benchLevelMeterSource(report, options, filter);
+    benchOutlineBuffer(report, options, filter);
+    benchStereoFieldBuffer(report, options, filter);
+
+    report.write(stdout);
+    return 0;
+}
@@ -0,0 +1,575 @@
+//==============================================================================
+/** genisysbench - runs a directory of WAVs through the library without a GUI.
+
+    Every mono 16-bit WAV in the directory goes through each pipeline mode in
+    turn. A file foo.wav is scored against the reference transcript in foo.txt
+    next to it, if there is one.
+
+        batch           LibGenisysProcessBatch, 16kHz files only
+        stream          LibGenisysFeedNativeFloat in blocks, 16kHz files only
+        offline         LibGenisysProcessFloat, resampled from the file's own rate
+        live            LibGenisysFeedFloat in blocks, resampled from the file's own rate
+        offline-denoise offline with RNNoise on, 48kHz files only
+        live-denoise    live with RNNoise on, 48kHz files only
+
+    Each mode reports its real-time factor (processing time over audio time),
+    the p50/p90/p99/max latency of each call it makes, the library's own
+    per-stage timings from LibGenisysGetStats, the peak RSS while it ran and
+    the word error rate of its transcripts. Files a mode can't take are
+    counted as skipped.
+
+    Usage: genisysbench <directory> [modes] [blockSize] [threads]
+
+    modes is a comma separated list and defaults to all of them. blockSize is
+    the number of samples per feed call (480, 10ms at 48kHz) and threads is the
+    batch worker count (0, one per hardware thread).
+*/
+
+#include "LibGenisysAPI.h"
+#include "wavio.h"
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#endif
+
+namespace
+{
+using Clock = std::chrono::steady_clock;
+
+double secondsSince(Clock::time_point start)
+{
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+//==============================================================================
+struct AudioFile
+{
+    std::string path;
+    std::string name;
+    int sampleRate = 0;
+    std::vector<float> samples;
+    std::vector<std::string> reference;
+    bool hasReference = false;
+    double loadSeconds = 0.0;
+
+    double getSeconds() const { return sampleRate > 0 ? double(samples.size()) / sampleRate : 0.0; }
+};
+
+std::vector<std::string> splitWords(const std::string& text)
+{
+    std::vector<std::string> words;
+    std::string word;
+
+    for (const char c : text)
+    {
+        if (std::isalnum((unsigned char)c) || c == '\'')
+        {
+            word += (char)std::tolower((unsigned char)c);
+        }
+        else if (!word.empty())
+        {
+            words.push_back(word);
+            word.clear();
+        }
+    }
+
+    if (!word.empty())
+        words.push_back(word);
+
+    return words;
+}
+
+/** Word level Levenshtein distance: substitutions, insertions and deletions */
+size_t wordErrors(const std::vector<std::string>& reference, const std::vector<std::string>& hypothesis)
+{
+    std::vector<size_t> previous(hypothesis.size() + 1), current(hypothesis.size() + 1);
+
+    for (size_t j = 0; j < previous.size(); ++j)
+        previous[j] = j;
+
+    for (size_t i = 1; i <= reference.size(); ++i)
+    {
+        current[0] = i;
+
+        for (size_t j = 1; j <= hypothesis.size(); ++j)
+        {
+            const size_t substitution = previous[j - 1] + (reference[i - 1] == hypothesis[j - 1] ? 0 : 1);
+            current[j] = std::min({ substitution, previous[j] + 1, current[j - 1] + 1 });
+        }
+
+        std::swap(previous, current);
+    }
+
+    return previous[hypothesis.size()];
+}
+
+bool loadFile(const std::filesystem::path& path, AudioFile& file)
+{
+    const auto start = Clock::now();
+
+    WavIO::Reader reader(path.string());
+    if (!reader.isOpen())
+        return false;
+
+    const auto header = reader.getHeader();
+    if (header.bitsPerSample != 16 || header.numberOfChannels != 1)
+        return false;
+
+    file.path = path.string();
+    file.name = path.filename().string();
+    file.sampleRate = header.sampleRate;
+    file.samples.resize(header.lengthInBytes / sizeof(int16_t));
+    file.samples.resize(size_t(std::max(reader.readSamples(file.samples), 0)));
+    file.loadSeconds = secondsSince(start);
+
+    std::ifstream referenceFile(std::filesystem::path(path).replace_extension(".txt"));
+    if (referenceFile)
+    {
+        std::stringstream text;
+        text << referenceFile.rdbuf();
+        file.reference = splitWords(text.str());
+        file.hasReference = true;
+    }
+
+    return true;
+}
+
+/** Peak RSS in KiB. On Linux the high water mark is reset first so each mode gets its own */
+void resetPeakRSS()
+{
+#if defined(__linux__)
+    if (auto* clearRefs = std::fopen("/proc/self/clear_refs", "w"))
+    {
+        std::fputs("5", clearRefs);
+        std::fclose(clearRefs);
+    }
+#endif
+}
+
+long peakRSS()
+{
+#if defined(__linux__)
+    std::ifstream status("/proc/self/status");
+    std::string line;
+
+    while (std::getline(status, line))
+        if (line.compare(0, 6, "VmHWM:") == 0)
+            return std::atol(line.c_str() + 6);
+#endif
+#if defined(__unix__) || defined(__APPLE__)
+    rusage usage {};
+    getrusage(RUSAGE_SELF, &usage);
+#if defined(__APPLE__)
+    return long(usage.ru_maxrss / 1024);
+#else
+    return long(usage.ru_maxrss);
+#endif
+#else
+    return 0;
+#endif
+}
+
+//==============================================================================
+struct Stage
+{
+    std::vector<double> samples;
+
+    double percentile(double p) const
+    {
+        if (samples.empty())
+            return 0.0;
+
+        auto sorted = samples;
+        std::sort(sorted.begin(), sorted.end());
+        const auto index = size_t(p * double(sorted.size() - 1) + 0.5);
+        return sorted[std::min(index, sorted.size() - 1)];
+    }
+};
+
+struct ModeResult
+{
+    std::map<std::string, Stage> stages;
+    double audioSeconds = 0.0;
+    double processSeconds = 0.0;
+    size_t referenceWords = 0;
+    size_t errors = 0;
+    int files = 0;
+    int skipped = 0;
+    int failed = 0;
+    long peakRSS = 0;
+
+    void score(const AudioFile& file, const std::string& transcript)
+    {
+        if (!file.hasReference)
+            return;
+
+        referenceWords += file.reference.size();
+        errors += wordErrors(file.reference, splitWords(transcript));
+    }
+};
+
+struct Options
+{
+    int blockSize = 480;
+    int threads = 0;
+};
+
+//==============================================================================
+void runBatch(LibGenisysInstance instance, const std::vector<AudioFile>& files, const Options& options, ModeResult& result)
+{
+    std::vector<const AudioFile*> native;
+    std::vector<const char*> paths;
+
+    for (const auto& file : files)
+    {
+        if (file.sampleRate != 16000)
+        {
+            ++result.skipped;
+            continue;
+        }
+
+        native.push_back(&file);
+        paths.push_back(file.path.c_str());
+    }
+
+    struct Context
+    {
+        const std::vector<const AudioFile*>* files;
+        ModeResult* result;
+    } context { &native, &result };
+
+    const auto start = Clock::now();
+    const auto status = LibGenisysProcessBatch(
+        instance,
+        paths.data(),
+        (int)paths.size(),
+        options.threads,
+        [](const LibGenisysBatchResult* fileResult, void* userData)
+        {
+            auto& ctx = *static_cast<Context*>(userData);
+            auto& mode = *ctx.result;
+
+            if (fileResult->status != LibGenisysStatusOk)
+            {
+                ++mode.failed;
+                return;
+            }
+
+            ++mode.files;
+            mode.audioSeconds += fileResult->audioSeconds;
+            mode.stages["read"].samples.push_back(fileResult->readSeconds);
+            mode.stages["inference"].samples.push_back(fileResult->inferenceSeconds);
+            mode.score(*(*ctx.files)[size_t(fileResult->index)], fileResult->transcript);
+        },
+        &context);
+    result.processSeconds = secondsSince(start);
+
+    if (status != LibGenisysStatusOk)
+        result.failed += (int)paths.size() - result.files - result.failed;
+}
+
+void runStream(LibGenisysInstance instance, const std::vector<AudioFile>& files, const Options& options, ModeResult& result)
+{
+    for (const auto& file : files)
+    {
+        if (file.sampleRate != 16000)
+        {
+            ++result.skipped;
+            continue;
+        }
+
+        const auto start = Clock::now();
+
+        if (LibGenisysOpenStream(instance) != LibGenisysStatusOk)
+        {
+            ++result.failed;
+            continue;
+        }
+
+        //Blocks are blockSize at 16kHz rather than at the device rate
+        auto& feed = result.stages["feed"].samples;
+        for (size_t offset = 0; offset < file.samples.size(); offset += size_t(options.blockSize))
+        {
+            const int blockSize = (int)std::min(size_t(options.blockSize), file.samples.size() - offset);
+            const auto feedStart = Clock::now();
+            LibGenisysFeedNativeFloat(instance, file.samples.data() + offset, blockSize);
+            feed.push_back(secondsSince(feedStart));
+        }
+
+        const auto finishStart = Clock::now();
+        const auto transcript = LibGenisysFinishStream(instance);
+        result.stages["finish"].samples.push_back(secondsSince(finishStart));
+
+        result.processSeconds += secondsSince(start);
+        result.audioSeconds += file.getSeconds();
+        ++result.files;
+        result.score(file, transcript);
+    }
+}
+
+bool prepare(LibGenisysInstance instance, const AudioFile& file, const Options& options, bool denoise)
+{
+    if (denoise && file.sampleRate != 48000)
+        return false;
+
+    if (LibGenisysInitialize(instance, options.blockSize, file.sampleRate) != LibGenisysStatusOk)
+        return false;
+
+    return LibGenisysSetDenoising(instance, denoise) == LibGenisysStatusOk;
+}
+
+void runOffline(LibGenisysInstance instance,
+                const std::vector<AudioFile>& files,
+                const Options& options,
+                bool denoise,
+                ModeResult& result)
+{
+    for (const auto& file : files)
+    {
+        if (!prepare(instance, file, options, denoise))
+        {
+            ++result.skipped;
+            continue;
+        }
+
+        //ProcessFloat takes a mutable buffer
+        auto samples = file.samples;
+
+        const auto start = Clock::now();
+        const auto transcript = LibGenisysProcessFloat(instance, samples.data(), (int)samples.size());
+        const auto seconds = secondsSince(start);
+
+        result.stages["process"].samples.push_back(seconds);
+        result.processSeconds += seconds;
+        result.audioSeconds += file.getSeconds();
+        ++result.files;
+        result.score(file, transcript);
+    }
+}
+
+void runLive(LibGenisysInstance instance,
+             const std::vector<AudioFile>& files,
+             const Options& options,
+             bool denoise,
+             ModeResult& result)
+{
+    for (const auto& file : files)
+    {
+        if (!prepare(instance, file, options, denoise))
+        {
+            ++result.skipped;
+            continue;
+        }
+
+        const auto start = Clock::now();
+
+        if (LibGenisysOpenStream(instance) != LibGenisysStatusOk)
+        {
+            ++result.failed;
+            continue;
+        }
+
+        auto& feed = result.stages["feed"].samples;
+        for (size_t offset = 0; offset < file.samples.size(); offset += size_t(options.blockSize))
+        {
+            const int blockSize = (int)std::min(size_t(options.blockSize), file.samples.size() - offset);
+            const auto feedStart = Clock::now();
+            LibGenisysFeedFloat(instance, file.samples.data() + offset, blockSize);
+            feed.push_back(secondsSince(feedStart));
+        }
+
+        const auto finishStart = Clock::now();
+        const auto transcript = LibGenisysFinishStream(instance);
+        result.stages["finish"].samples.push_back(secondsSince(finishStart));
+
+        result.processSeconds += secondsSince(start);
+        result.audioSeconds += file.getSeconds();
+        ++result.files;
+        result.score(file, transcript);
+    }
+}
+
+void printLibraryStats(LibGenisysInstance instance)
+{
+    LibGenisysStageStats stats[LibGenisysStageCount];
+    const int numStages = (int)LibGenisysStageCount;
+
+    if (LibGenisysGetStats(instance, stats, numStages) != LibGenisysStatusOk)
+        return;
+
+    for (const auto& stage : stats)
+    {
+        if (stage.count == 0)
+            continue;
+
+        std::printf("    [%-11s] n %6llu  wall p50 %9.3fms  p95 %9.3fms  p99 %9.3fms  cpu total %8.3fs\n",
+                    stage.name,
+                    stage.count,
+                    1000.0 * stage.wallP50,
+                    1000.0 * stage.wallP95,
+                    1000.0 * stage.wallP99,
+                    stage.cpuTotal);
+    }
+}
+
+void printResult(const std::string& mode, const ModeResult& result)
+{
+    const double rtf = result.audioSeconds > 0.0 ? result.processSeconds / result.audioSeconds : 0.0;
+
+    std::printf("%-16s files %3d  skipped %3d  failed %3d  audio %8.2fs  rtf %6.3f  peak rss %7.1f MiB",
+                mode.c_str(),
+                result.files,
+                result.skipped,
+                result.failed,
+                result.audioSeconds,
+                rtf,
+                double(result.peakRSS) / 1024.0);
+
+    if (result.referenceWords > 0)
+        std::printf("  wer %5.1f%% (%zu/%zu)",
+                    100.0 * double(result.errors) / double(result.referenceWords),
+                    result.errors,
+                    result.referenceWords);
+    else
+        std::printf("  wer n/a");
+
+    std::printf("\n");
+
+    for (const auto& stage : result.stages)
+    {
+        std::printf("    %-12s n %6zu  p50 %9.3fms  p90 %9.3fms  p99 %9.3fms  max %9.3fms\n",
+                    stage.first.c_str(),
+                    stage.second.samples.size(),
+                    1000.0 * stage.second.percentile(0.50),
+                    1000.0 * stage.second.percentile(0.90),
+                    1000.0 * stage.second.percentile(0.99),
+                    1000.0 * stage.second.percentile(1.00));
+    }
+}
+
+std::vector<std::string> splitList(const std::string& list)
+{
+    std::vector<std::string> items;
+    std::stringstream stream(list);
+    std::string item;
+
+    while (std::getline(stream, item, ','))
+        if (!item.empty())
+            items.push_back(item);
+
+    return items;
+}
+} // namespace
+
+//==============================================================================
+int main(int argc, char* argv[])
+{
+    if (argc < 2)
+    {
+        std::fprintf(stderr, "Usage: %s <directory> [modes] [blockSize] [threads]\n", argv[0]);
+        return 1;
+    }
+
+    const std::filesystem::path directory(argv[1]);
+    const auto modes = splitList(argc > 2 ? argv[2] : "batch,stream,offline,live,offline-denoise,live-denoise");
+
+    Options options;
+    options.blockSize = argc > 3 ? std::max(1, std::atoi(argv[3])) : options.blockSize;
+    options.threads = argc > 4 ? std::max(0, std::atoi(argv[4])) : options.threads;
+
+    std::error_code error;
+    std::vector<std::filesystem::path> paths;
+    for (const auto& entry : std::filesystem::directory_iterator(directory, error))
+    {
+        auto extension = entry.path().extension().string();
+        std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+
+        if (entry.is_regular_file() && extension == ".wav")
+            paths.push_back(entry.path());
+    }
+
+    if (error)
+    {
+        std::fprintf(stderr, "Can't read %s: %s\n", directory.string().c_str(), error.message().c_str());
+        return 1;
+    }
+
+    std::sort(paths.begin(), paths.end());
+
+    std::vector<AudioFile> files;
+    Stage load;
+    for (const auto& path : paths)
+    {
+        AudioFile file;
+        if (!loadFile(path, file))
+        {
+            std::fprintf(stderr, "Skipping %s: not a mono 16-bit WAV\n", path.string().c_str());
+            continue;
+        }
+
+        load.samples.push_back(file.loadSeconds);
+        files.push_back(std::move(file));
+    }
+
+    if (files.empty())
+    {
+        std::fprintf(stderr, "No usable WAV files in %s\n", directory.string().c_str());
+        return 1;
+    }
+
+    std::printf("%zu files, block size %d, load p50 %.3fms max %.3fms\n\n",
+                files.size(),
+                options.blockSize,
+                1000.0 * load.percentile(0.50),
+                1000.0 * load.percentile(1.00));
+
+    const auto createStart = Clock::now();
+    LibGenisysInstance instance = LibGenisysCreate();
+    std::printf("model load %.3fs\n\n", secondsSince(createStart));
+
+    int exitCode = 0;
+
+    for (const auto& mode : modes)
+    {
+        ModeResult result;
+        resetPeakRSS();
+        LibGenisysResetStats(instance);
+
+        if (mode == "batch")
+            runBatch(instance, files, options, result);
+        else if (mode == "stream")
+            runStream(instance, files, options, result);
+        else if (mode == "offline" || mode == "offline-denoise")
+            runOffline(instance, files, options, mode == "offline-denoise", result);
+        else if (mode == "live" || mode == "live-denoise")
+            runLive(instance, files, options, mode == "live-denoise", result);
+        else
+        {
+            std::fprintf(stderr, "Unknown mode %s\n", mode.c_str());
+            exitCode = 1;
+            continue;
+        }
+
+        result.peakRSS = peakRSS();
+        printResult(mode, result);
+        printLibraryStats(instance);
+
+        if (result.failed > 0)
+            exitCode = 1;
+    }
+
+    LibGenisysDestroy(instance);
+    return exitCode;
+}
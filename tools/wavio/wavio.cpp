@@ -7,26 +7,33 @@
 #include "wavreader.h"
 #include "wavwriter.h"
 
+#include "juce/juce_AudioDataConverters.h"
+
 #include <algorithm>
 #include <cassert>
+#include <cstring>
+
+#if defined(_WIN32)
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 namespace WavIO {
 
+// Vectorised in AudioDataConverters
 static void convertInt16ToFloat(const int16_t* inputBuffer, float* outputBuffer, int numberOfSamples)
 {
-    for (int i = 0; i < numberOfSamples; i++)
-    {
-        float sampleFloat = static_cast<float>(inputBuffer[i]) / static_cast<float>(INT16_MAX);
-        outputBuffer[i] = std::clamp(sampleFloat, -1.0f, 1.0f);
-    }
+    juce::AudioDataConverters::convertInt16LEToFloat(inputBuffer, outputBuffer, numberOfSamples);
 }
 
 static void convertFloatToInt16(const float* inputBuffer, int16_t* outputBuffer, int numberOfSamples)
 {
-    for (int i = 0; i < numberOfSamples; i++)
-    {
-        outputBuffer[i] = static_cast<int16_t>(std::clamp(inputBuffer[i], -1.0f, 1.0f) * INT16_MAX);
-    }
+    juce::AudioDataConverters::convertFloatToInt16LE(inputBuffer, outputBuffer, numberOfSamples);
 }
 
 Reader::Reader(std::string pathToFile) {
@@ -83,6 +90,205 @@ int Reader::readSamples(std::vector<float>& buffer)
     return numSamplesRead;
 }
 
+ChunkReader::ChunkReader(const std::string& pathToFile, size_t samplesPerChunk)
+    : reader(pathToFile), chunk(std::max(samplesPerChunk, size_t(1)))
+{
+}
+
+size_t ChunkReader::readChunk()
+{
+    if (!isOpen()) {
+        return 0;
+    }
+
+    const auto numBytesRead = reader.readData(reinterpret_cast<unsigned char*>(chunk.data()),
+                                              (unsigned int)(chunk.size() * sizeof(int16_t)));
+
+    // A trailing odd byte can only come from a truncated file, drop it
+    return numBytesRead > 0 ? size_t(numBytesRead) / sizeof(int16_t) : 0;
+}
+
+static uint32_t readTag(const unsigned char* p)
+{
+    return (uint32_t(p[0]) << 24) | (uint32_t(p[1]) << 16) | (uint32_t(p[2]) << 8) | uint32_t(p[3]);
+}
+
+static uint32_t readInt32(const unsigned char* p)
+{
+    return uint32_t(p[0]) | (uint32_t(p[1]) << 8) | (uint32_t(p[2]) << 16) | (uint32_t(p[3]) << 24);
+}
+
+static uint16_t readInt16(const unsigned char* p)
+{
+    return uint16_t(p[0] | (p[1] << 8));
+}
+
+static constexpr uint32_t tag(char a, char b, char c, char d)
+{
+    return (uint32_t(a) << 24) | (uint32_t(b) << 16) | (uint32_t(c) << 8) | uint32_t(d);
+}
+
+MappedReader::MappedReader(const std::string& pathToFile)
+{
+#if defined(_WIN32)
+    HANDLE file = CreateFileA(pathToFile.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return;
+    }
+    fileHandle = file;
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+        unmap();
+        return;
+    }
+
+    mappingHandle = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mappingHandle == nullptr) {
+        unmap();
+        return;
+    }
+
+    mapping = static_cast<const unsigned char*>(MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0));
+    mappingSize = size_t(size.QuadPart);
+#else
+    int fd = open(pathToFile.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size <= 0) {
+        close(fd);
+        return;
+    }
+
+    void* address = mmap(nullptr, size_t(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd); // the mapping keeps the file alive
+    if (address == MAP_FAILED) {
+        return;
+    }
+
+    // The data is read front to back once, so ask for aggressive readahead
+    madvise(address, size_t(info.st_size), MADV_SEQUENTIAL);
+
+    mapping = static_cast<const unsigned char*>(address);
+    mappingSize = size_t(info.st_size);
+#endif
+
+    if (mapping == nullptr || !parse(mapping, mappingSize)) {
+        unmap();
+    }
+}
+
+MappedReader::~MappedReader() {
+    unmap();
+}
+
+void MappedReader::unmap()
+{
+#if defined(_WIN32)
+    if (mapping != nullptr) {
+        UnmapViewOfFile(mapping);
+    }
+    if (mappingHandle != nullptr) {
+        CloseHandle(mappingHandle);
+    }
+    if (fileHandle != nullptr) {
+        CloseHandle(fileHandle);
+    }
+#else
+    if (mapping != nullptr) {
+        munmap(const_cast<unsigned char*>(mapping), mappingSize);
+    }
+#endif
+    mapping = nullptr;
+    mappingSize = 0;
+    fileHandle = nullptr;
+    mappingHandle = nullptr;
+    data = nullptr;
+    dataSize = 0;
+}
+
+bool MappedReader::parse(const unsigned char* file, size_t fileSize)
+{
+    // Same chunk walk as wav_read_open, but over memory and honouring RIFF pad bytes
+    size_t pos = 0;
+    bool haveFormat = false;
+
+    while (pos + 12 <= fileSize) {
+        uint32_t length = readInt32(file + pos + 4);
+        if (readTag(file + pos) != tag('R', 'I', 'F', 'F') || readTag(file + pos + 8) != tag('W', 'A', 'V', 'E')) {
+            pos += 8 + size_t(length) + (length & 1);
+            continue;
+        }
+
+        size_t end = (!length || length >= 0x7fff0000) ? fileSize : std::min(fileSize, pos + 8 + size_t(length));
+        pos += 12;
+
+        while (pos + 8 <= end) {
+            const uint32_t subtag = readTag(file + pos);
+            const uint32_t sublength = readInt32(file + pos + 4);
+            const unsigned char* chunk = file + pos + 8;
+            pos += 8;
+
+            if (subtag == tag('d', 'a', 't', 'a')) {
+                const bool streamed = !sublength || sublength >= 0x7fff0000 || sublength > end - pos;
+                data = chunk;
+                dataSize = streamed ? end - pos : sublength;
+                header.lengthInBytes = (unsigned int)dataSize;
+                if (streamed) {
+                    break;
+                }
+            }
+
+            if (sublength > end - pos) {
+                break;
+            }
+
+            if (subtag == tag('f', 'm', 't', ' ')) {
+                if (sublength < 16) {
+                    // Insufficient data for 'fmt '
+                    return false;
+                }
+                header.format = readInt16(chunk);
+                header.numberOfChannels = readInt16(chunk + 2);
+                header.sampleRate = int(readInt32(chunk + 4));
+                header.bitsPerSample = readInt16(chunk + 14);
+                if (header.format == 0xfffe) {
+                    if (sublength < 28) {
+                        // Insufficient data for waveformatex
+                        return false;
+                    }
+                    header.format = int(readInt32(chunk + 24));
+                }
+                haveFormat = true;
+            }
+
+            pos += size_t(sublength) + (sublength & 1);
+        }
+
+        if (data != nullptr) {
+            break;
+        }
+    }
+
+    return data != nullptr && haveFormat && header.format && header.sampleRate;
+}
+
+const int16_t* MappedReader::getSamples16() const
+{
+    const uint16_t one = 1;
+    const bool littleEndian = *reinterpret_cast<const unsigned char*>(&one) == 1;
+
+    if (data == nullptr || header.bitsPerSample != 16 || !littleEndian
+        || reinterpret_cast<uintptr_t>(data) % alignof(int16_t) != 0) {
+        return nullptr;
+    }
+
+    return reinterpret_cast<const int16_t*>(data);
+}
+
 Writer::Writer(std::string pathToFile, const Header& header)
 {
     handle = wav_write_open(pathToFile.c_str(), header.sampleRate, header.bitsPerSample, header.numberOfChannels, header.lengthInBytes);
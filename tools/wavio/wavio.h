@@ -4,6 +4,8 @@
 
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
 #include <string>
 #include <vector>
 
@@ -53,6 +55,76 @@ private:
     std::vector<unsigned char> tmpBuffer;
 };
 
+/// Reads a WAV file through a read-only memory mapping instead of stdio.
+/// The RIFF chunks are parsed straight from the mapping and the PCM data is handed out in place,
+/// so nothing is copied until the caller touches it. Streamed files (data length 0) run to the end of the file.
+class MappedReader
+{
+public:
+    /// Maps the file at the given path. Callers should check the result of isOpen afterwards.
+    explicit MappedReader(const std::string& pathToFile);
+    ~MappedReader();
+
+    MappedReader(const MappedReader&) = delete;
+    MappedReader& operator=(const MappedReader&) = delete;
+
+    /// @returns whether the file is mapped and has a fmt and a data chunk.
+    inline bool isOpen() const { return data != nullptr; };
+
+    Header getHeader() const { return header; }
+
+    /// @returns the PCM bytes of the data chunk, valid for the lifetime of the reader.
+    const unsigned char* getData() const { return data; }
+    size_t getDataSize() const { return dataSize; }
+
+    /// @returns the data chunk as 16-bit samples, or nullptr if the file isn't 16-bit PCM,
+    /// the chunk is misaligned or the host isn't little endian.
+    const int16_t* getSamples16() const;
+    size_t getNumSamples16() const { return dataSize / sizeof(int16_t); }
+
+private:
+    bool parse(const unsigned char* file, size_t fileSize);
+    void unmap();
+
+    const unsigned char* mapping = nullptr;
+    size_t mappingSize = 0;
+    void* fileHandle = nullptr;
+    void* mappingHandle = nullptr;
+
+    Header header {};
+    const unsigned char* data = nullptr;
+    size_t dataSize = 0;
+};
+
+/// Pulls the data chunk of a WAV file in fixed-size blocks of 16-bit samples through one reused buffer,
+/// so memory use doesn't depend on the length of the file. Streamed files (data length 0) are read to the end.
+class ChunkReader
+{
+public:
+    /// Opens the file at the given path. Callers should check the result of isOpen afterwards.
+    ChunkReader(const std::string& pathToFile, size_t samplesPerChunk);
+
+    ChunkReader(const ChunkReader&) = delete;
+    ChunkReader& operator=(const ChunkReader&) = delete;
+
+    /// @returns whether the file is open and holds 16-bit samples.
+    inline bool isOpen() { return reader.isOpen() && reader.getHeader().bitsPerSample == 16; };
+
+    Header getHeader() const { return reader.getHeader(); }
+
+    /// Reads the next block into the chunk buffer, overwriting the previous one.
+    /// @returns the number of samples read, less than the chunk size only at the end of the data and 0 after it.
+    size_t readChunk();
+
+    /// @returns the samples of the last readChunk call, valid until the next one.
+    const int16_t* getChunk() const { return chunk.data(); }
+    size_t getChunkSize() const { return chunk.size(); }
+
+private:
+    Reader reader;
+    std::vector<int16_t> chunk;
+};
+
 class Writer
 {
 public: